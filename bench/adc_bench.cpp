@@ -0,0 +1,69 @@
+/*
+    This file is a part of the wiringBone library
+    Oversampling decimation throughput and noise against a synthetic noisy 12 bit source
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "ADC.h"
+
+#define SAMPLES (1 << 22)
+#define NOISE_LSB 0.7                   // Gaussian noise on the source, in 12 bit counts
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static double gaussian(void)
+{
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+  return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+// The true input of a block sweeps one count so every fractional position is covered
+static double truth(size_t block)
+{
+  return 2048.0 + (block % 1024) / 1024.0;
+}
+
+int main()
+{
+  std::vector<uint16_t> samples(SAMPLES);
+
+  for(uint8_t extraBits = 1; extraBits <= 4; extraBits++)
+  {
+    size_t count = (size_t)1 << (2 * extraBits), blocks = SAMPLES / count;
+    for(size_t block = 0; block < blocks; block++)
+    for(size_t index = 0; index < count; index++)
+    samples[block * count + index] = (uint16_t) lround(truth(block) + NOISE_LSB * gaussian());
+
+    for(adcDither dither : {ditherNone, ditherRandom})
+    {
+      std::vector<uint32_t> values(blocks);
+      double start = seconds();
+      for(size_t block = 0; block < blocks; block++)
+      values[block] = adcDecimate(&samples[block * count], extraBits, dither);
+      double elapsed = seconds() - start;
+
+      // Errors in 12 bit counts, so every resolution compares on one scale
+      double bias = 0, power = 0;
+      for(size_t block = 0; block < blocks; block++)
+      {
+        double error = values[block] / (double)(1 << extraBits) - truth(block);
+        bias += error;
+        power += error * error;
+      }
+      bias /= blocks;
+      printf("%2d bits %-6s %12.0f samples/s, bias %+.4f, rms %.4f counts\n",
+             12 + extraBits, dither == ditherNone ? "none" : "random",
+             SAMPLES / elapsed, bias, sqrt(power / blocks - bias * bias));
+    }
+  }
+  return 0;
+}
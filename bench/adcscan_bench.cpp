@@ -0,0 +1,94 @@
+/*
+    This file is a part of the wiringBone library
+    ADC scan filter throughput in samples/sec over a FIFO standing in for the IIO buffer
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ADCSCAN.h"
+
+#define CHANNELS 4
+#define SCANS 2000000
+#define BLOCK 256
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// The attributes ADCStream writes, as plain files in a scratch directory
+static std::string fakeDevice(void)
+{
+  char root[] = "/tmp/adcscan_benchXXXXXX";
+  std::string device = mkdtemp(root);
+
+  mkdir((device + "/scan_elements").c_str(), 0755);
+  mkdir((device + "/buffer").c_str(), 0755);
+  for(const char *name : {"/buffer/enable", "/buffer/length", "/buffer/watermark"})
+  close(creat((device + name).c_str(), 0644));
+  for(int channel = 0; channel < CHANNELS; channel++)
+  close(creat((device + "/scan_elements/in_voltage" + std::to_string(channel) + "_en").c_str(), 0644));
+  mkfifo((device + "/chardev").c_str(), 0644);
+  return device;
+}
+
+int main()
+{
+  static const char *names[] = {"none", "moving average 8", "iir 0.1", "median 7"};
+  static const ADCFilterType types[] = {filterNone, filterMovingAverage, filterIIR, filterMedian};
+  std::string device = fakeDevice();
+  std::atomic<bool> done(false);
+
+  // Held open for writing so the reader never sees the FIFO close between runs
+  int fifo = open((device + "/chardev").c_str(), O_RDWR | O_NONBLOCK);
+  std::vector<uint16_t> noisy(BLOCK * CHANNELS);
+  for(size_t index = 0; index < noisy.size(); index++)
+  noisy[index] = 2048 + (index % CHANNELS) * 100 + rand() % 64 - 32;
+
+  std::thread source([&]
+  {
+    struct pollfd writable = {fifo, POLLOUT, 0};
+    // Under PIPE_BUF a nonblocking write goes in whole or not at all
+    while(!done)
+    if(poll(&writable, 1, 100) > 0)
+    write(fifo, noisy.data(), noisy.size() * sizeof(uint16_t));
+  });
+
+  ADCScan scan(device.c_str(), (device + "/chardev").c_str());
+  if(scan.begin((1 << CHANNELS) - 1, BLOCK) < 0 || !scan.buffered())
+  {
+    fprintf(stderr, "ADC scan bench: stream did not start\n");
+    return 1;
+  }
+
+  for(int type = 0; type < 4; type++)
+  {
+    for(int channel = 0; channel < CHANNELS; channel++)
+    scan.setFilter((adcPin) channel, types[type], type == 3 ? 7 : 8, 0.1f);
+
+    size_t scans = 0;
+    double start = seconds();
+    while(scans < SCANS)
+    scans += scan.read(BLOCK, 1000);
+    printf("%-18s %12.0f samples/s\n", names[type], scans * CHANNELS / (seconds() - start));
+  }
+
+  done = true;
+  scan.end();
+  source.join();
+  close(fifo);
+  system(("rm -rf " + device).c_str());
+  return 0;
+}
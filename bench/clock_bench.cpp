@@ -0,0 +1,59 @@
+/*
+    This file is a part of the wiringBone library
+    delayMicroseconds() jitter, achieved vs requested delay, against a plain nanosleep
+*/
+
+#include <stdio.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "CLOCK.h"
+
+static uint64_t now(clockid_t clock)
+{
+  struct timespec value;
+  clock_gettime(clock, &value);
+  return (uint64_t)value.tv_sec * 1000000000ULL + value.tv_nsec;
+}
+
+static void plainSleep(uint32_t duration)
+{
+  struct timespec wait = {(time_t)(duration / 1000000), (long)(duration % 1000000) * 1000};
+  nanosleep(&wait, NULL);
+}
+
+// Lateness in us past the requested delay: mean, 99th percentile and worst, plus CPU used per delay
+template <typename Delay>
+static void measure(const char *name, uint32_t duration, int repeats, Delay delayFor)
+{
+  std::vector<double> late(repeats);
+  uint64_t cpu = now(CLOCK_PROCESS_CPUTIME_ID);
+  double mean = 0;
+
+  for(int count = 0; count < repeats; count++)
+  {
+    uint64_t start = now(CLOCK_MONOTONIC);
+    delayFor(duration);
+    late[count] = (now(CLOCK_MONOTONIC) - start) / 1000.0 - duration;
+    mean += late[count];
+  }
+  cpu = now(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+  std::sort(late.begin(), late.end());
+  printf("%-18s %6u us: late mean %8.2f  p99 %8.2f  max %8.2f us, cpu %6.1f%%\n", name, duration,
+         mean / repeats, late[repeats * 99 / 100], late[repeats - 1],
+         100.0 * cpu / (repeats * (duration * 1000.0 + mean / repeats * 1000.0)));
+}
+
+int main()
+{
+  static const uint32_t durations[] = {10, 50, 100, 500, 1000, 5000};
+
+  startClock();
+  for(uint32_t duration : durations)
+  {
+    int repeats = duration >= 1000 ? 200 : 1000;
+    measure("delayMicroseconds", duration, repeats, [](uint32_t wait) { delayMicroseconds(wait); });
+    measure("nanosleep", duration, repeats, plainSleep);
+  }
+  return 0;
+}
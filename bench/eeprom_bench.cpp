@@ -0,0 +1,116 @@
+/*
+    This file is a part of the wiringBone library
+    EEPROM put/get on the mapped store vs the old fopen per byte file access
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+#include "EEPROM.h"
+
+#define RECORDS 20000
+#define LEGACY_RECORDS 500
+#define LEGACY_FILE "../LEGACY_EEPROM.bin"
+
+struct Record {
+  uint32_t count;
+  float level;
+  char name[24];
+};
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// The access the library had before the mapped store: open, seek, one byte, close
+static uint8_t legacyRead(int address)
+{
+  uint8_t x = 0;
+  FILE *fp = fopen(LEGACY_FILE, "r+b");
+  fseek(fp, address, SEEK_SET);
+  if(fread(&x, 1, 1, fp) != 1)
+  x = 0;
+  fclose(fp);
+  return x;
+}
+
+static void legacyWrite(int address, uint8_t x)
+{
+  FILE *fp = fopen(LEGACY_FILE, "r+b");
+  fseek(fp, address, SEEK_SET);
+  fwrite(&x, 1, 1, fp);
+  fclose(fp);
+}
+
+int main()
+{
+  // EEPROM_FILE sits in the parent directory, so run from a scratch one
+  char root[] = "/tmp/eeprom_benchXXXXXX";
+  if(mkdtemp(root) == NULL || chdir(root) < 0 || mkdir("work", 0755) < 0 || chdir("work") < 0)
+  {
+    perror("EEPROM bench scratch directory");
+    return 1;
+  }
+  FILE *fp = fopen(LEGACY_FILE, "w+b");
+  for(int index = 0; index <= E2END; index++)
+  fputc(0xff, fp);
+  fclose(fp);
+
+  Record record, copy;
+  memset(&record, 0, sizeof(record));
+  strcpy(record.name, "gate");
+  double start, elapsed;
+
+  EEPROM.setCommitInterval(0);
+  start = seconds();
+  for(int count = 0; count < RECORDS; count++)
+  {
+    record.count = count;
+    EEPROM.put((count * sizeof(record)) % (E2END + 1 - sizeof(record)), record);
+  }
+  elapsed = seconds() - start;
+  printf("mapped put:  %10.0f records/s\n", RECORDS / elapsed);
+
+  start = seconds();
+  for(int count = 0; count < RECORDS; count++)
+  EEPROM.get((count * sizeof(record)) % (E2END + 1 - sizeof(record)), copy);
+  elapsed = seconds() - start;
+  printf("mapped get:  %10.0f records/s\n", RECORDS / elapsed);
+
+  start = seconds();
+  EEPROM.commit();
+  printf("commit:      %10.3f ms\n", (seconds() - start) * 1e3);
+
+  // Old put compared each byte before writing it, as EERef::update() does
+  start = seconds();
+  for(int count = 0; count < LEGACY_RECORDS; count++)
+  {
+    record.count = count;
+    int address = (count * sizeof(record)) % (E2END + 1 - sizeof(record));
+    for(size_t index = 0; index < sizeof(record); index++)
+    if(legacyRead(address + index) != ((uint8_t*) &record)[index])
+    legacyWrite(address + index, ((uint8_t*) &record)[index]);
+  }
+  elapsed = seconds() - start;
+  printf("legacy put:  %10.0f records/s\n", LEGACY_RECORDS / elapsed);
+
+  start = seconds();
+  for(int count = 0; count < LEGACY_RECORDS; count++)
+  {
+    int address = (count * sizeof(record)) % (E2END + 1 - sizeof(record));
+    for(size_t index = 0; index < sizeof(copy); index++)
+    ((uint8_t*) &copy)[index] = legacyRead(address + index);
+  }
+  elapsed = seconds() - start;
+  printf("legacy get:  %10.0f records/s\n", LEGACY_RECORDS / elapsed);
+
+  system((std::string("rm -rf ") + root).c_str());
+  return 0;
+}
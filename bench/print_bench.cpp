@@ -0,0 +1,73 @@
+/*
+    This file is a part of the wiringBone library
+    Print formatting, prints/sec and write() calls per print
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "Print.h"
+
+#define PRINTS 1000000
+
+// Keeps the last line, as a serial port's buffer would, and counts the calls that reach it
+class Sink : public Print
+{
+  public:
+    unsigned long calls;
+    size_t length;
+    uint8_t line[64];
+
+    virtual size_t write(uint8_t c)
+    {
+      calls++;
+      line[length++ & 63] = c;
+      return 1;
+    }
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+      calls++;
+      for(size_t index = 0; index < size; index++)
+      line[length++ & 63] = buffer[index];
+      return size;
+    }
+};
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+template <typename Body>
+static void measure(const char *name, Sink &sink, Body body)
+{
+  double start;
+
+  sink.calls = 0;
+  sink.length = 0;
+  start = seconds();
+  for(long count = 0; count < PRINTS; count++)
+  body(count);
+  printf("%-22s %10.0f prints/s, %.3f writes/print\n", name,
+         PRINTS / (seconds() - start), (double) sink.calls / PRINTS);
+}
+
+int main()
+{
+  Sink sink;
+  char buffer[32];
+
+  measure("print(long)", sink, [&](long count) { sink.print(count * 7919 - 3000000); });
+  measure("println(long)", sink, [&](long count) { sink.println(count * 7919); });
+  measure("print(long, HEX)", sink, [&](long count) { sink.print(count * 7919, HEX); });
+  measure("println(double, 3)", sink, [&](long count) { sink.println(count * 0.37 - 1000.0, 3); });
+  measure("println(char[])", sink, [&](long count) { sink.println("gate open"); });
+  // The same integer lines through snprintf and a single write, for reference
+  measure("snprintf + write", sink, [&](long count)
+  {
+    sink.write((const uint8_t*) buffer, snprintf(buffer, sizeof(buffer), "%ld\r\n", count * 7919));
+  });
+  return 0;
+}
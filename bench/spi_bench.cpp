@@ -0,0 +1,88 @@
+/*
+    This file is a part of the wiringBone library
+    SPI transactions/sec, one ioctl per transaction vs chained segments
+*/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include <vector>
+#include "SPI.h"
+
+#define TRANSACTIONS 200000
+#define BATCH 64                        // Register reads chained per message
+
+static unsigned long ioctlCount;
+
+// spidev stand-in: SPI requests loop tx back to rx after one real syscall for the kernel entry
+extern "C" int ioctl(int fd, unsigned long request, ...)
+{
+  va_list args;
+  va_start(args, request);
+  void *arg = va_arg(args, void*);
+  va_end(args);
+
+  if(_IOC_TYPE(request) != SPI_IOC_MAGIC)
+  return syscall(SYS_ioctl, fd, request, arg);
+
+  syscall(SYS_getppid);
+  if(_IOC_NR(request) == 0)
+  {
+    struct spi_ioc_transfer *transfers = (struct spi_ioc_transfer*) arg;
+    size_t count = _IOC_SIZE(request) / sizeof(struct spi_ioc_transfer);
+    for(size_t index = 0; index < count; index++)
+    if(transfers[index].tx_buf && transfers[index].rx_buf)
+    memcpy((void*) transfers[index].rx_buf, (const void*) transfers[index].tx_buf, transfers[index].len);
+    ioctlCount++;
+  }
+  return 0;
+}
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main()
+{
+  SPIClass bus("/dev/null");
+  uint8_t command[BATCH], reply[BATCH][3];
+  uint8_t tx[4] = {0x80, 0, 0, 0}, rx[4];
+  std::vector<SPISegment> segments(2 * BATCH);
+  double start, elapsed;
+
+  bus.begin();
+
+  ioctlCount = 0;
+  start = seconds();
+  for(int count = 0; count < TRANSACTIONS; count++)
+  bus.transfer(tx, rx, sizeof(tx));
+  elapsed = seconds() - start;
+  printf("single:  %10.0f transactions/s, %.3f ioctls/transaction\n",
+         TRANSACTIONS / elapsed, (double) ioctlCount / TRANSACTIONS);
+
+  // Command byte then three reply bytes per read, chip select dropped between reads
+  for(int index = 0; index < BATCH; index++)
+  {
+    command[index] = 0x80 | index;
+    segments[2 * index] = SPISegment{&command[index], NULL, 1, false, 0, 0};
+    segments[2 * index + 1] = SPISegment{NULL, reply[index], 3, true, 0, 0};
+  }
+  ioctlCount = 0;
+  start = seconds();
+  for(int count = 0; count < TRANSACTIONS / BATCH; count++)
+  bus.transfer(segments.data(), segments.size());
+  elapsed = seconds() - start;
+  printf("chained: %10.0f transactions/s, %.3f ioctls/transaction\n",
+         (TRANSACTIONS / BATCH) * BATCH / elapsed, (double) ioctlCount / ((TRANSACTIONS / BATCH) * BATCH));
+
+  bus.end();
+  return 0;
+}
@@ -0,0 +1,64 @@
+/*
+    This file is a part of the wiringBone library
+    Context switches per second, coroutine tasks on the event loop vs threads on a condition variable
+*/
+
+#include <stdio.h>
+#include <time.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "TASK.h"
+
+#define SWITCHES 1000000
+#define TASKS 2
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static int finished;
+
+// Each delayMs(0) posts the task back and resumes the next one waiting
+static Task yielder(int count)
+{
+  for(int index = 0; index < count; index++)
+  co_await delayMs(0);
+  if(++finished == TASKS)
+  eventLoop().stop();
+}
+
+int main()
+{
+  double start = seconds();
+  for(int task = 0; task < TASKS; task++)
+  yielder(SWITCHES / TASKS);
+  eventLoop().run();
+  double elapsed = seconds() - start;
+  printf("coroutines: %10.0f switches/s, %6.1f ns/switch\n", SWITCHES / elapsed, elapsed * 1e9 / SWITCHES);
+
+  // Two threads handing a turn back and forth, each hand-off one switch
+  std::mutex turnMutex;
+  std::condition_variable turnCv;
+  int turn = 0;
+  auto player = [&](int self)
+  {
+    std::unique_lock<std::mutex> lock(turnMutex);
+    for(int index = 0; index < SWITCHES / 2; index++)
+    {
+      turnCv.wait(lock, [&] { return turn == self; });
+      turn = 1 - self;
+      turnCv.notify_one();
+    }
+  };
+  start = seconds();
+  std::thread other(player, 1);
+  player(0);
+  other.join();
+  elapsed = seconds() - start;
+  printf("threads:    %10.0f switches/s, %6.1f ns/switch\n", SWITCHES / elapsed, elapsed * 1e9 / SWITCHES);
+  return 0;
+}
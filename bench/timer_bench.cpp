@@ -0,0 +1,63 @@
+/*
+    This file is a part of the wiringBone library
+    Timer wheel schedule and cancel cost for 100k timers, and firing lateness
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <vector>
+#include "TIMER.h"
+
+#define TIMERS 100000
+#define FIRED 2000
+#define FIRED_SPAN_MS 300
+
+static uint64_t nowNanos(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+int main()
+{
+  TimerWheel wheel;
+  std::vector<TimerId> ids(TIMERS);
+  uint64_t start;
+
+  // Delays up to a minute reach every level of the wheel
+  srand(1);
+  start = nowNanos();
+  for(int index = 0; index < TIMERS; index++)
+  ids[index] = wheel.schedule(1000 + rand() % 60000, [] {});
+  printf("schedule: %8.1f ns/timer\n", (double)(nowNanos() - start) / TIMERS);
+
+  start = nowNanos();
+  for(int index = 0; index < TIMERS; index++)
+  wheel.cancel(ids[index]);
+  printf("cancel:   %8.1f ns/timer, %zu left\n", (double)(nowNanos() - start) / TIMERS, wheel.size());
+
+  // Lateness past the requested delay, the 1 ms tick rounding included
+  std::vector<uint64_t> late(FIRED);
+  std::atomic<int> fired(0);
+  for(int index = 0; index < FIRED; index++)
+  {
+    uint32_t delay = 1 + rand() % FIRED_SPAN_MS;
+    uint64_t due = nowNanos() + delay * 1000000ULL;
+    wheel.schedule(delay, [&, index, due] { late[index] = nowNanos() - due; fired++; });
+  }
+  while(fired < FIRED)
+  usleep(10000);
+
+  uint64_t total = 0, worst = 0;
+  for(uint64_t value : late)
+  {
+    total += value;
+    worst = value > worst ? value : worst;
+  }
+  printf("fire:     late mean %.3f ms, max %.3f ms\n", total / 1e6 / FIRED, worst / 1e6);
+  return 0;
+}
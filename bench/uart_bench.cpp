@@ -0,0 +1,98 @@
+/*
+    This file is a part of the wiringBone library
+    UART bytes/sec and writev calls per message over a pty pair
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "UART.h"
+
+#define MESSAGES 102400
+#define MESSAGE_LENGTH 32
+#define BATCH 64                        // Frames per writeFrames() call
+
+static unsigned long writevCount;
+
+// Counts the port's writes, then makes the real system call
+extern "C" ssize_t writev(int fd, const struct iovec *iov, int iovcnt)
+{
+  writevCount++;
+  return syscall(SYS_writev, fd, iov, iovcnt);
+}
+
+static double seconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static void report(const char *name, double elapsed)
+{
+  printf("%-8s %10.0f bytes/s, %.3f writev/message\n", name,
+         (double) MESSAGES * MESSAGE_LENGTH / elapsed, (double) writevCount / MESSAGES);
+}
+
+int main()
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if(master < 0 || grantpt(master) < 0 || unlockpt(master) < 0)
+  {
+    perror("pty open failed");
+    return 1;
+  }
+
+  // The far end just keeps the pty drained
+  std::atomic<bool> done(false);
+  std::thread sink([&]
+  {
+    char buffer[4096];
+    while(!done)
+    read(master, buffer, sizeof(buffer));
+  });
+
+  HardwareSerial port(ptsname(master));
+  uint8_t message[MESSAGE_LENGTH];
+  std::vector<struct iovec> frames(BATCH, iovec{message, sizeof(message)});
+  double start;
+
+  memset(message, 'x', sizeof(message));
+  message[MESSAGE_LENGTH - 1] = '\n';
+  port.begin(115200);
+
+  writevCount = 0;
+  start = seconds();
+  for(int count = 0; count < MESSAGES; count++)
+  for(int index = 0; index < MESSAGE_LENGTH; index++)
+  port.write(message[index]);
+  report("bytes:", seconds() - start);
+
+  writevCount = 0;
+  start = seconds();
+  for(int count = 0; count < MESSAGES; count++)
+  port.write(message, sizeof(message));
+  report("message:", seconds() - start);
+
+  writevCount = 0;
+  start = seconds();
+  for(int count = 0; count < MESSAGES / BATCH; count++)
+  port.writeFrames(frames.data(), frames.size());
+  report("frames:", seconds() - start);
+
+  // One more message wakes the sink so it sees done
+  done = true;
+  port.write(message, sizeof(message));
+  port.end();
+  sink.join();
+  close(master);
+  return 0;
+}
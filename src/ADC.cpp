@@ -30,14 +30,22 @@
 
 #include "CommonDefines.h"
 #include "ADC.h"
+#include "ADCSTREAM.h"
 
 #define defaultResolution 12
+#define maxOversampledResolution 16
 
 static uint8_t readResolution = 10;
 
 int readADC(adcPin pin)
 {
   int value;
+
+  // The raw attribute is busy while the buffer runs, the stream has a fresher value anyway
+  ADCStream *stream = ADCStream::current();
+  if(stream && (value = stream->latest(pin)) >= 0)
+  return value;
+
   char path[52];
   sprintf(path, "/sys/bus/iio/devices/iio:device0/in_voltage%d_raw", (uint8_t)pin);
   std::ifstream analogFile(path);
@@ -46,6 +54,71 @@ int readADC(adcPin pin)
   return value;
 }
 
+// One open for the whole block, then a conversion per pread
+size_t readADCBlock(adcPin pin, uint16_t *samples, size_t count)
+{
+  char path[52], value[16];
+  sprintf(path, "/sys/bus/iio/devices/iio:device0/in_voltage%d_raw", (uint8_t)pin);
+
+  int fd = open(path, O_RDONLY);
+  if(fd < 0)
+  {
+    perror("ADC block read cannot open raw attribute");
+    return 0;
+  }
+
+  size_t index;
+  for(index = 0; index < count; index++)
+  {
+    ssize_t length = pread(fd, value, sizeof(value) - 1, 0);
+    if(length <= 0)
+    {
+      perror("ADC block read failed");
+      break;
+    }
+    value[length] = '\0';
+    samples[index] = atoi(value);
+  }
+  close(fd);
+  return index;
+}
+
+// Per thread, so concurrent analogRead() calls never race on it
+static thread_local uint32_t ditherState = 2463534242u;
+
+// xorshift32, only needs to be uncorrelated with the signal
+static uint32_t ditherNext(void)
+{
+  ditherState ^= ditherState << 13;
+  ditherState ^= ditherState >> 17;
+  ditherState ^= ditherState << 5;
+  return ditherState;
+}
+
+uint32_t adcDecimate(const uint16_t *samples, uint8_t extraBits, adcDither dither)
+{
+  size_t count = (size_t)1 << (2 * extraBits);
+  uint32_t sum = 0;
+  for(size_t index = 0; index < count; index++)
+  sum += samples[index];
+
+  if(extraBits == 0)
+  return sum;
+
+  // Summing 4^k samples gains 2k bits, k of them are noise and are rounded away
+  uint32_t rounding = 1u << (extraBits - 1);
+  if(dither == ditherRandom)
+  rounding = ditherNext() & ((1u << extraBits) - 1);
+  return (sum + rounding) >> extraBits;
+}
+
+static adcDither readDither = ditherNone;
+
+void analogReadDither(adcDither mode)
+{
+  readDither = mode;
+}
+
 void analogReadResolution(uint8_t bits)
 {
   readResolution = bits;
@@ -53,8 +126,24 @@ void analogReadResolution(uint8_t bits)
 
 int analogRead(adcPin pin)
 {
-  uint32_t value = readADC(pin);
+  uint32_t value;
+
+  // Extra bits come from oversampling, unless a stream owns the ADC and raw reads would repeat its latest value
+  uint8_t extraBits = 0;
+  if(readResolution > defaultResolution && ADCStream::current() == NULL)
+  extraBits = readResolution < maxOversampledResolution ? readResolution - defaultResolution : maxOversampledResolution - defaultResolution;
+
+  if(extraBits)
+  {
+    uint16_t samples[1 << (2 * (maxOversampledResolution - defaultResolution))];
+    size_t count = (size_t)1 << (2 * extraBits);
+    if(readADCBlock(pin, samples, count) < count)
+    return -1;
+    value = adcDecimate(samples, extraBits, readDither);
+    return(value << (readResolution - defaultResolution - extraBits));
+  }
 
+  value = readADC(pin);
   if(readResolution <= defaultResolution)
   value = value >> (defaultResolution - readResolution);
   else
@@ -22,16 +22,28 @@
 #define ADC_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include "PINS.h"
 #include "CommonDefines.h"
 
 typedef enum {AIN0=0, AIN1=1, AIN2=2, AIN3=3, AIN4=4, AIN5=5, AIN6=6} adcPin;
 
+// Rounding used when oversampled sums are decimated
+typedef enum {ditherNone=0, ditherRandom=1} adcDither;
+
 int readADC(adcPin pin);
 
+size_t readADCBlock(adcPin pin, uint16_t *samples, size_t count);
+
+// Decimates 4^extraBits consecutive samples into one value extraBits wider
+uint32_t adcDecimate(const uint16_t *samples, uint8_t extraBits, adcDither dither = ditherNone);
+
+// Resolutions of 13 to 16 bits oversample, wider ones are shifted from 16 bits
 void analogReadResolution(uint8_t bits);
 
+void analogReadDither(adcDither mode);
+
 int analogRead(adcPin pin);
 
 int analogRead(uint8_t pin);
@@ -0,0 +1,261 @@
+/*
+    This file is a part of the wiringBone library
+    Time aligned multi-channel ADC scans with per-channel block filters
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <algorithm>
+#include "ADCSCAN.h"
+
+ADCScan::ADCScan(const char *device, const char *chardev)
+    : device(device),
+      stream(device, chardev),
+      useStream(false),
+      channelCount(0),
+      blockScans(0),
+      samplePeriod(0),
+      nextScan(0),
+      filters(ADC_CHANNEL_COUNT) {
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        slots[channel] = -1;
+        rawFds[channel] = -1;
+        filters[channel] = Filter{filterNone, 1, 1.0f, 0.0f, {}, false};
+    }
+}
+
+ADCScan::~ADCScan() {
+    end();
+}
+
+int ADCScan::begin(uint8_t channelMask, size_t blockScans) {
+    end();
+
+    this->blockScans = blockScans ? blockScans : ADC_SCAN_BLOCK;
+    channelCount = 0;
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        slots[channel] = (channelMask & (1 << channel)) ? channelCount++ : -1;
+        filters[channel].primed = false;
+    }
+    if (channelCount == 0) {
+        fprintf(stderr, "ADC scan: no channels selected\n");
+        return -1;
+    }
+
+    rawBlock.assign(this->blockScans * channelCount, 0);
+    filteredBlock.assign(this->blockScans * channelCount, 0.0f);
+    stamps.assign(this->blockScans, 0);
+
+    // Keep a few blocks in the ring so filtering one block does not drop the next
+    useStream = stream.begin(channelMask, this->blockScans * 4) == 0;
+    if (useStream) {
+        return 0;
+    }
+
+    fprintf(stderr, "ADC scan: IIO buffer unavailable, reading raw attributes\n");
+    char name[32];
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        if (slots[channel] < 0) {
+            continue;
+        }
+        sprintf(name, "/in_voltage%d_raw", channel);
+        if ((rawFds[channel] = open((device + name).c_str(), O_RDONLY)) < 0) {
+            perror("ADC scan cannot open raw attribute");
+            end();
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void ADCScan::end() {
+    stream.end();
+    useStream = false;
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        if (rawFds[channel] >= 0) {
+            close(rawFds[channel]);
+            rawFds[channel] = -1;
+        }
+    }
+}
+
+bool ADCScan::buffered(void) {
+    return useStream;
+}
+
+void ADCScan::setSamplePeriod(uint32_t period_us) {
+    samplePeriod = period_us;
+    nextScan = 0;
+}
+
+void ADCScan::setFilter(adcPin pin, ADCFilterType type, uint16_t window, float alpha) {
+    if ((unsigned)pin >= ADC_CHANNEL_COUNT) {
+        return;
+    }
+    if (window == 0) {
+        window = 1;
+    }
+    if (type == filterMedian) {
+        // Odd windows keep the median on a sample
+        window = std::min<uint16_t>(window | 1, ADC_MEDIAN_MAX);
+    }
+    if (alpha <= 0.0f || alpha > 1.0f) {
+        alpha = 1.0f;
+    }
+    filters[pin] = Filter{type, window, alpha, 0.0f, {}, false};
+}
+
+size_t ADCScan::read(size_t maxScans, unsigned long timeout) {
+    size_t scans = std::min(maxScans, blockScans);
+    if (channelCount == 0 || scans == 0) {
+        return 0;
+    }
+
+    scans = useStream ? readBuffered(scans, timeout) : readAttributes(scans);
+
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        if (slots[channel] >= 0) {
+            size_t offset = slots[channel] * blockScans;
+            applyFilter(filters[channel], &rawBlock[offset], &filteredBlock[offset], scans);
+        }
+    }
+    return scans;
+}
+
+const uint16_t *ADCScan::raw(adcPin pin) {
+    return (unsigned)pin < ADC_CHANNEL_COUNT && slots[pin] >= 0 ? &rawBlock[slots[pin] * blockScans] : NULL;
+}
+
+const float *ADCScan::filtered(adcPin pin) {
+    return (unsigned)pin < ADC_CHANNEL_COUNT && slots[pin] >= 0 ? &filteredBlock[slots[pin] * blockScans] : NULL;
+}
+
+const int64_t *ADCScan::timestamps(void) {
+    return stamps.data();
+}
+
+// Deinterleaves spans from the stream ring straight into the per-channel arrays
+size_t ADCScan::readBuffered(size_t scans, unsigned long timeout) {
+    size_t collected = 0;
+    ADCSpan span;
+
+    while (collected < scans && stream.acquire(span, collected ? 0 : timeout)) {
+        size_t count = std::min(span.scans, scans - collected);
+        for (uint8_t slot = 0; slot < channelCount; slot++) {
+            uint16_t *__restrict out = &rawBlock[slot * blockScans + collected];
+            const uint16_t *__restrict in = span.samples + slot;
+            for (size_t scan = 0; scan < count; scan++) {
+                out[scan] = in[scan * span.channels];
+            }
+        }
+        std::copy(span.timestamps, span.timestamps + count, &stamps[collected]);
+        stream.release(count);
+        collected += count;
+    }
+    return collected;
+}
+
+// Without the buffer every scan costs one pread per channel on already open attributes
+size_t ADCScan::readAttributes(size_t scans) {
+    char value[16];
+    struct timespec now;
+
+    for (size_t scan = 0; scan < scans; scan++) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (samplePeriod) {
+            // Absolute deadlines, so time spent filtering between blocks does not stretch the period
+            int64_t current = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+            if (nextScan > current) {
+                struct timespec due = {(time_t)(nextScan / 1000000000LL), (long)(nextScan % 1000000000LL)};
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL);
+                clock_gettime(CLOCK_MONOTONIC, &now);
+            } else if (current - nextScan > samplePeriod * 1000LL) {
+                // First scan, or behind by more than a period: restart the schedule from now
+                nextScan = current;
+            }
+            nextScan += samplePeriod * 1000LL;
+        }
+        stamps[scan] = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+        for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+            if (slots[channel] < 0) {
+                continue;
+            }
+            ssize_t length = pread(rawFds[channel], value, sizeof(value) - 1, 0);
+            if (length <= 0) {
+                perror("ADC scan read failed");
+                return scan;
+            }
+            value[length] = '\0';
+            rawBlock[slots[channel] * blockScans + scan] = atoi(value);
+        }
+    }
+    return scans;
+}
+
+// Kernels work on a whole channel block at a time so the inner loops stay free of branches
+void ADCScan::applyFilter(Filter &filter, const uint16_t *__restrict input, float *__restrict output, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    if (filter.type == filterNone) {
+        for (size_t index = 0; index < count; index++) {
+            output[index] = input[index];
+        }
+        return;
+    }
+
+    if (filter.type == filterIIR) {
+        // First order low pass; each output depends on the previous one
+        float state = filter.primed ? filter.state : input[0];
+        float alpha = filter.alpha;
+        for (size_t index = 0; index < count; index++) {
+            state += alpha * ((float)input[index] - state);
+            output[index] = state;
+        }
+        filter.state = state;
+        filter.primed = true;
+        return;
+    }
+
+    // Moving average and median look back window - 1 samples, into the previous block if needed
+    size_t back = filter.window - 1;
+    if (!filter.primed) {
+        filter.history.assign(back, input[0]);
+        filter.primed = true;
+    }
+    extended.resize(back + count);
+    std::copy(filter.history.begin(), filter.history.end(), extended.begin());
+    int32_t *__restrict ext = extended.data();
+    for (size_t index = 0; index < count; index++) {
+        ext[back + index] = input[index];
+    }
+
+    if (filter.type == filterMovingAverage) {
+        // Integer prefix sums are exact, then every window sum is one subtraction
+        prefix.resize(back + count + 1);
+        int32_t *__restrict sums = prefix.data();
+        sums[0] = 0;
+        for (size_t index = 0; index < back + count; index++) {
+            sums[index + 1] = sums[index] + ext[index];
+        }
+        float scale = 1.0f / filter.window;
+        for (size_t index = 0; index < count; index++) {
+            output[index] = (float)(sums[index + filter.window] - sums[index]) * scale;
+        }
+    }
+    else {
+        int32_t window[ADC_MEDIAN_MAX];
+        size_t middle = back / 2;
+        for (size_t index = 0; index < count; index++) {
+            std::copy(ext + index, ext + index + filter.window, window);
+            std::nth_element(window, window + middle, window + filter.window);
+            output[index] = window[middle];
+        }
+    }
+
+    std::copy(extended.end() - back, extended.end(), filter.history.begin());
+}
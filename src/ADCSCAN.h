@@ -0,0 +1,79 @@
+/*
+    This file is a part of the wiringBone library
+    Time aligned multi-channel ADC scans with per-channel block filters
+*/
+
+#ifndef ADCSCAN_H
+#define ADCSCAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "ADCSTREAM.h"
+
+#define ADC_SCAN_BLOCK 256      // Scans per read() unless begin() asks otherwise
+#define ADC_MEDIAN_MAX 15       // Longest median window
+
+typedef enum { filterNone, filterMovingAverage, filterIIR, filterMedian } ADCFilterType;
+
+class ADCScan {
+public:
+    explicit ADCScan(const char *device = ADC_IIO_DEVICE, const char *chardev = ADC_IIO_CHARDEV);
+    ~ADCScan();
+
+    // Samples the channels in channelMask together, through the IIO buffer when it can be
+    // enabled and otherwise by reading every channel's raw attribute once per scan
+    int begin(uint8_t channelMask, size_t blockScans = ADC_SCAN_BLOCK);
+    void end();
+    bool buffered(void);
+
+    // Spaces the scans of the raw-attribute fallback period_us apart, 0 reads them back to back.
+    // The IIO buffer keeps the rate the device was set up with
+    void setSamplePeriod(uint32_t period_us);
+
+    // window is the length for moving average and median filters; alpha the IIR coefficient (0..1]
+    void setFilter(adcPin pin, ADCFilterType type, uint16_t window = 8, float alpha = 0.1f);
+
+    // Collects up to maxScans scans, waiting up to timeout ms for the first, then filters them.
+    // The per-channel arrays below hold the result until the next read()
+    size_t read(size_t maxScans = ADC_SCAN_BLOCK, unsigned long timeout = 1000);
+
+    const uint16_t *raw(adcPin pin);        // Unfiltered samples, NULL if pin is not scanned
+    const float *filtered(adcPin pin);      // Filtered samples in ADC counts
+    const int64_t *timestamps(void);        // CLOCK_MONOTONIC ns, one per scan
+
+private:
+    struct Filter {
+        ADCFilterType type;
+        uint16_t window;
+        float alpha;
+        float state;                        // IIR output
+        std::vector<int32_t> history;       // Last window - 1 samples of the previous block
+        bool primed;
+    };
+
+    std::string device;                     // IIO device directory, also holds the raw attributes
+    ADCStream stream;
+    bool useStream;
+    uint8_t channelCount;
+    int8_t slots[ADC_CHANNEL_COUNT];
+    int rawFds[ADC_CHANNEL_COUNT];
+    size_t blockScans;
+    uint32_t samplePeriod;                  // us between fallback scans
+    int64_t nextScan;                       // CLOCK_MONOTONIC ns the next fallback scan is due
+
+    // Channel major (structure of arrays): channel slot s occupies [s * blockScans, (s + 1) * blockScans)
+    std::vector<uint16_t> rawBlock;
+    std::vector<float> filteredBlock;
+    std::vector<int64_t> stamps;
+    std::vector<Filter> filters;
+    std::vector<int32_t> extended;          // History followed by the block
+    std::vector<int32_t> prefix;
+
+    size_t readBuffered(size_t scans, unsigned long timeout);
+    size_t readAttributes(size_t scans);
+    void applyFilter(Filter &filter, const uint16_t *input, float *output, size_t count);
+};
+
+#endif
@@ -0,0 +1,400 @@
+/*
+    This file is a part of the wiringBone library
+    Continuous ADC capture through the IIO triggered buffer
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <chrono>
+#include <sys/eventfd.h>
+#include "ADCSTREAM.h"
+
+static std::atomic<ADCStream*> currentStream(nullptr);
+
+// Quiet writes are for attributes that older kernels or fake directories may lack
+static int writeAttribute(const std::string &path, const char *value, bool quiet = false)
+{
+  FILE *fd;
+  if((fd = fopen(path.c_str(), "w")) == NULL)
+  {
+    if(!quiet)
+    perror(("ADC stream cannot open " + path).c_str());
+    return -1;
+  }
+  int status = fputs(value, fd) < 0 ? -1 : 0;
+  if(fclose(fd) != 0)
+  status = -1;
+  if(status < 0 && !quiet)
+  perror(("ADC stream cannot write " + path).c_str());
+  return status;
+}
+
+static int64_t monotonicNow(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+ADCStream::ADCStream(const char *device, const char *chardev)
+    : device(device),
+      chardev(chardev),
+      channelMask(0),
+      channelCount(0),
+      timestamp{},
+      hasTimestamp(false),
+      scanBytes(0),
+      capacity(0),
+      head(0),
+      tail(0),
+      waiting(false),
+      running(false),
+      overrunCount(0),
+      lastStamp(0),
+      fd(-1),
+      stopFd(-1) {
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        positions[channel] = -1;
+        latestValues[channel] = 0;
+    }
+}
+
+ADCStream::~ADCStream() {
+    end();
+}
+
+// Type attributes read like "le:u12/16>>0"; the TI ADC format is assumed when one is missing
+int ADCStream::readElement(const char *name, Element &element) {
+    std::string path = device + "/scan_elements/" + name + "_type";
+    char endian = 'l', sign = 'u';
+    unsigned bits = 12, storage = 16, shift = 0;
+
+    FILE *fd = fopen(path.c_str(), "r");
+    if (fd != NULL) {
+        if (fscanf(fd, "%ce:%c%u/%u>>%u", &endian, &sign, &bits, &storage, &shift) != 5) {
+            fprintf(stderr, "ADC stream cannot parse %s\n", path.c_str());
+            fclose(fd);
+            return -1;
+        }
+        fclose(fd);
+    }
+    else if (strcmp(name, "in_timestamp") == 0) {
+        sign = 's';
+        bits = storage = 64;
+    }
+
+    if (storage != 8 && storage != 16 && storage != 32 && storage != 64) {
+        fprintf(stderr, "ADC stream: unsupported %u bit storage for %s\n", storage, name);
+        return -1;
+    }
+    element.bytes = storage / 8;
+    element.bits = bits;
+    element.shift = shift;
+    element.bigEndian = endian == 'b';
+    element.isSigned = sign == 's';
+    return 0;
+}
+
+int ADCStream::enable(uint8_t mask) {
+    std::string scan = device + "/scan_elements/";
+    char name[32];
+
+    // Scan elements cannot change while the buffer runs
+    writeAttribute(device + "/buffer/enable", "0", true);
+
+    elements.clear();
+    channelCount = 0;
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        positions[channel] = -1;
+        sprintf(name, "in_voltage%d", channel);
+        if (!(mask & (1 << channel))) {
+            writeAttribute(scan + name + "_en", "0", true);
+            continue;
+        }
+
+        Element element;
+        if (writeAttribute(scan + name + "_en", "1") < 0 || readElement(name, element) < 0) {
+            return -1;
+        }
+        positions[channel] = channelCount++;
+        elements.push_back(element);
+    }
+    if (channelCount == 0) {
+        fprintf(stderr, "ADC stream: no channels selected\n");
+        return -1;
+    }
+
+    hasTimestamp = access((scan + "in_timestamp_en").c_str(), F_OK) == 0 &&
+                   writeAttribute(scan + "in_timestamp_en", "1") == 0 &&
+                   readElement("in_timestamp", timestamp) == 0;
+    if (hasTimestamp) {
+        writeAttribute(device + "/current_timestamp_clock", "monotonic", true);
+    }
+
+    // Every element is aligned to its own size and the scan to the largest one
+    size_t offset = 0, align = 1;
+    for (Element &element : elements) {
+        offset = (offset + element.bytes - 1) / element.bytes * element.bytes;
+        element.offset = offset;
+        offset += element.bytes;
+        align = element.bytes > align ? element.bytes : align;
+    }
+    if (hasTimestamp) {
+        offset = (offset + timestamp.bytes - 1) / timestamp.bytes * timestamp.bytes;
+        timestamp.offset = offset;
+        offset += timestamp.bytes;
+        align = timestamp.bytes > align ? timestamp.bytes : align;
+    }
+    scanBytes = (offset + align - 1) / align * align;
+
+    char value[16];
+    sprintf(value, "%d", ADC_STREAM_KERNEL_LENGTH);
+    if (writeAttribute(device + "/buffer/length", value) < 0) {
+        return -1;
+    }
+    // Wake the reader once per block rather than once per scan
+    sprintf(value, "%d", ADC_STREAM_BLOCK);
+    writeAttribute(device + "/buffer/watermark", value, true);
+    return writeAttribute(device + "/buffer/enable", "1");
+}
+
+void ADCStream::disable(void) {
+    std::string scan = device + "/scan_elements/";
+    char name[32];
+
+    writeAttribute(device + "/buffer/enable", "0", true);
+    for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+        if (channelMask & (1 << channel)) {
+            sprintf(name, "in_voltage%d_en", channel);
+            writeAttribute(scan + name, "0", true);
+        }
+    }
+    if (hasTimestamp) {
+        writeAttribute(scan + "in_timestamp_en", "0", true);
+    }
+}
+
+int ADCStream::begin(uint8_t channelMask, size_t capacity) {
+    end();
+
+    this->channelMask = channelMask & ((1 << ADC_CHANNEL_COUNT) - 1);
+    if (enable(this->channelMask) < 0) {
+        disable();
+        return -1;
+    }
+
+    this->capacity = capacity ? capacity : ADC_STREAM_CAPACITY;
+    samples.assign(this->capacity * channelCount, 0);
+    timestamps.assign(this->capacity, 0);
+    head = 0;
+    tail = 0;
+    overrunCount = 0;
+    lastStamp = 0;
+
+    if ((fd = open(chardev.c_str(), O_RDONLY | O_NONBLOCK)) < 0) {
+        perror("ADC stream cannot open the character device");
+        disable();
+        return -1;
+    }
+    if ((stopFd = eventfd(0, 0)) < 0) {
+        perror("ADC stream eventfd failed");
+        end();
+        return -1;
+    }
+
+    running = true;
+    reader = std::thread(&ADCStream::run, this);
+    currentStream = this;
+    return 0;
+}
+
+void ADCStream::end() {
+    ADCStream *self = this;
+    currentStream.compare_exchange_strong(self, nullptr);
+
+    if (reader.joinable()) {
+        uint64_t one = 1;
+        if (write(stopFd, &one, sizeof(one)) < 0) {
+            perror("ADC stream stop failed");
+        }
+        reader.join();
+    }
+    if (stopFd >= 0) {
+        close(stopFd);
+        stopFd = -1;
+    }
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+        disable();
+    }
+    running = false;
+    readyCv.notify_all();
+}
+
+bool ADCStream::acquire(ADCSpan &span, unsigned long timeout) {
+    size_t first = tail.load(std::memory_order_relaxed);
+    size_t ready = head.load(std::memory_order_acquire) - first;
+
+    if (ready == 0 && timeout > 0) {
+        std::unique_lock<std::mutex> lock(readyMutex);
+        waiting = true;
+        readyCv.wait_for(lock, std::chrono::milliseconds(timeout),
+                         [&] { return head.load() != first || !running; });
+        waiting = false;
+        ready = head.load(std::memory_order_acquire) - first;
+    }
+    if (ready == 0) {
+        return false;
+    }
+
+    size_t index = first % capacity;
+    size_t contiguous = capacity - index;
+    span.samples = &samples[index * channelCount];
+    span.timestamps = &timestamps[index];
+    span.scans = ready < contiguous ? ready : contiguous;
+    span.channels = channelCount;
+    return true;
+}
+
+void ADCStream::release(size_t scans) {
+    size_t first = tail.load(std::memory_order_relaxed);
+    size_t ready = head.load(std::memory_order_acquire) - first;
+    tail.store(first + (scans < ready ? scans : ready), std::memory_order_release);
+}
+
+uint8_t ADCStream::channels(void) {
+    return channelCount;
+}
+
+int ADCStream::position(adcPin pin) {
+    return (unsigned)pin < ADC_CHANNEL_COUNT ? positions[pin] : -1;
+}
+
+int ADCStream::latest(adcPin pin) {
+    int offset = position(pin);
+    return offset < 0 || !running ? -1 : latestValues[pin].load(std::memory_order_relaxed);
+}
+
+unsigned long ADCStream::overruns(void) {
+    return overrunCount;
+}
+
+bool ADCStream::active(void) {
+    return running;
+}
+
+ADCStream *ADCStream::current(void) {
+    return currentStream;
+}
+
+static uint64_t loadElement(const uint8_t *data, uint8_t bytes, bool bigEndian) {
+    uint64_t value = 0;
+    for (uint8_t index = 0; index < bytes; index++) {
+        value |= (uint64_t)data[bigEndian ? bytes - 1 - index : index] << (8 * index);
+    }
+    return value;
+}
+
+// Copies complete scans into the ring, dropping scans the application has no room for
+size_t ADCStream::store(const uint8_t *data, size_t scans, int64_t now) {
+    size_t next = head.load(std::memory_order_relaxed);
+    int64_t period = lastStamp && scans ? (now - lastStamp) / (int64_t)scans : 0;
+    size_t stored = 0;
+
+    for (size_t scan = 0; scan < scans; scan++, data += scanBytes) {
+        if (next - tail.load(std::memory_order_acquire) >= capacity) {
+            overrunCount++;
+            continue;
+        }
+
+        size_t index = next % capacity;
+        uint16_t *values = &samples[index * channelCount];
+        for (size_t channel = 0; channel < elements.size(); channel++) {
+            const Element &element = elements[channel];
+            uint64_t raw = loadElement(data + element.offset, element.bytes, element.bigEndian) >> element.shift;
+            values[channel] = element.bits < 64 ? raw & ((1ULL << element.bits) - 1) : raw;
+        }
+        if (hasTimestamp) {
+            timestamps[index] = (int64_t)loadElement(data + timestamp.offset, timestamp.bytes, timestamp.bigEndian);
+        }
+        else {
+            // No timestamp channel: spread the scans evenly up to the time the block arrived
+            timestamps[index] = now - period * (int64_t)(scans - 1 - scan);
+        }
+        next++;
+        stored++;
+    }
+    lastStamp = now;
+
+    if (stored) {
+        const uint16_t *values = &samples[((next - 1) % capacity) * channelCount];
+        for (int channel = 0; channel < ADC_CHANNEL_COUNT; channel++) {
+            if (positions[channel] >= 0) {
+                latestValues[channel].store(values[positions[channel]], std::memory_order_relaxed);
+            }
+        }
+        head.store(next);
+        if (waiting) {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            readyCv.notify_all();
+        }
+    }
+    return stored;
+}
+
+void ADCStream::run() {
+    std::vector<uint8_t> block(scanBytes * ADC_STREAM_BLOCK);
+    size_t pending = 0;
+    struct pollfd fds[2];
+
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = stopFd;
+    fds[1].events = POLLIN;
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("ADC stream poll failed");
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+        if (!(fds[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+            continue;
+        }
+
+        ssize_t count = read(fd, block.data() + pending, block.size() - pending);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                continue;
+            }
+            perror("ADC stream read failed");
+            break;
+        }
+        if (count == 0) {
+            // Device removed, or the writer of a FIFO went away
+            break;
+        }
+
+        // A read may end mid scan; the partial scan waits for the rest
+        pending += count;
+        size_t scans = pending / scanBytes;
+        store(block.data(), scans, monotonicNow());
+        pending -= scans * scanBytes;
+        memmove(block.data(), block.data() + scans * scanBytes, pending);
+    }
+
+    std::lock_guard<std::mutex> lock(readyMutex);
+    running = false;
+    readyCv.notify_all();
+}
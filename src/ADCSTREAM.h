@@ -0,0 +1,102 @@
+/*
+    This file is a part of the wiringBone library
+    Continuous ADC capture through the IIO triggered buffer
+*/
+
+#ifndef ADCSTREAM_H
+#define ADCSTREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include "ADC.h"
+
+#define ADC_IIO_DEVICE  "/sys/bus/iio/devices/iio:device0"
+#define ADC_IIO_CHARDEV "/dev/iio:device0"
+
+#define ADC_CHANNEL_COUNT 7
+#define ADC_STREAM_CAPACITY 4096        // Scans held for the application
+#define ADC_STREAM_KERNEL_LENGTH 1024   // Scans held by the kernel buffer
+#define ADC_STREAM_BLOCK 256            // Scans taken from the character device per read
+
+// Contiguous run of scans; samples are interleaved, channels values per scan in channel order
+struct ADCSpan {
+    const uint16_t *samples;
+    const int64_t *timestamps;      // CLOCK_MONOTONIC ns, one per scan
+    size_t scans;
+    uint8_t channels;
+};
+
+class ADCStream {
+public:
+    // The paths can point at a fake IIO directory and a FIFO when no ADC is present
+    explicit ADCStream(const char *device = ADC_IIO_DEVICE, const char *chardev = ADC_IIO_CHARDEV);
+    ~ADCStream();
+
+    // Bit n of channelMask enables AINn. Enables the scan elements and the buffer, then starts reading
+    int begin(uint8_t channelMask, size_t capacity = ADC_STREAM_CAPACITY);
+    void end();
+
+    // Waits up to timeout ms for scans. The span runs up to the end of the ring and
+    // stays valid until release()
+    bool acquire(ADCSpan &span, unsigned long timeout);
+    void release(size_t scans);
+
+    uint8_t channels(void);             // Values per scan
+    int position(adcPin pin);           // Offset of pin within a scan, -1 if not captured
+    int latest(adcPin pin);             // Most recent value of pin, -1 if not captured
+    unsigned long overruns(void);       // Scans dropped because the application fell behind
+    bool active(void);
+
+    static ADCStream *current(void);    // Running stream that owns the ADC, if any
+
+private:
+    struct Element {
+        uint8_t offset;                 // Byte offset within a scan
+        uint8_t bytes;                  // Storage size
+        uint8_t bits;                   // Significant bits
+        uint8_t shift;
+        bool bigEndian;
+        bool isSigned;
+    };
+
+    std::string device;
+    std::string chardev;
+    uint8_t channelMask;
+    uint8_t channelCount;
+    int8_t positions[ADC_CHANNEL_COUNT];
+    std::vector<Element> elements;
+    Element timestamp;
+    bool hasTimestamp;
+    size_t scanBytes;
+
+    std::vector<uint16_t> samples;
+    std::vector<int64_t> timestamps;
+    size_t capacity;
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+    std::atomic<bool> waiting;
+    std::atomic<bool> running;
+    std::atomic<uint16_t> latestValues[ADC_CHANNEL_COUNT];
+    std::mutex readyMutex;
+    std::condition_variable readyCv;
+    unsigned long overrunCount;
+    int64_t lastStamp;
+
+    int fd;
+    int stopFd;
+    std::thread reader;
+
+    int enable(uint8_t mask);
+    void disable(void);
+    int readElement(const char *name, Element &element);
+    size_t store(const uint8_t *data, size_t scans, int64_t now);
+    void run();
+};
+
+#endif
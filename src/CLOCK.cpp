@@ -25,67 +25,108 @@
 #include <unistd.h>
 #include <stdint.h>
 #include <errno.h>
-#include <sys/time.h>
+#include <time.h>
 
 #include "CommonDefines.h"
 #include "CLOCK.h"
 
-static uint64_t startMillis, startMicros;
+// Sleeps end on a kernel timer, which wakes late by a scheduling latency; the
+// last stretch before a deadline is spun so delays keep microsecond precision
+#define DEFAULT_SPIN_NANOS 100000ULL
+#define MAX_SPIN_NANOS 2000000ULL
+#define CALIBRATION_SLEEPS 16
+#define CALIBRATION_SLEEP_NANOS 200000ULL
 
-void startClock()
-{
-  struct timeval timeValue;
+static uint64_t startNanos;
+static uint64_t spinNanos = DEFAULT_SPIN_NANOS;
 
-  gettimeofday(&timeValue, NULL);
-
-  startMillis = (uint64_t)timeValue.tv_sec * (uint64_t)1000    + (uint64_t)(timeValue.tv_usec / 1000);
-  startMicros = (uint64_t)timeValue.tv_sec * (uint64_t)1000000 + (uint64_t)(timeValue.tv_usec);
+static uint64_t monotonicNanos()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
 }
 
-void delay(uint32_t duration)
+static void sleepUntil(uint64_t deadline)
 {
-  struct timeval currentTime, delayLength, endTime;
-
-  gettimeofday(&currentTime, NULL);
+  uint64_t now = monotonicNanos();
+
+  if(deadline > now + spinNanos)
+  {
+    struct timespec wake;
+    uint64_t target = deadline - spinNanos;
+    wake.tv_sec  = target / 1000000000ULL;
+    wake.tv_nsec = target % 1000000000ULL;
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR);
+  }
+
+  while(monotonicNanos() < deadline);
+}
 
-  delayLength.tv_sec  = duration / 1000;
-  delayLength.tv_usec = (duration % 1000) * 1000;  
+// The spin tail covers the worst wakeup lateness seen over a few short sleeps
+static void calibrateSpin()
+{
+  uint64_t worst = 0;
+
+  for(int i = 0; i < CALIBRATION_SLEEPS; i++)
+  {
+    struct timespec wake;
+    uint64_t target = monotonicNanos() + CALIBRATION_SLEEP_NANOS;
+    wake.tv_sec  = target / 1000000000ULL;
+    wake.tv_nsec = target % 1000000000ULL;
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL) == EINTR);
+
+    uint64_t late = monotonicNanos() - target;
+    if(late > worst)
+    worst = late;
+  }
+
+  // Half again as much for margin, within bounds that keep the CPU mostly asleep
+  worst += worst / 2;
+  if(worst < DEFAULT_SPIN_NANOS / 10)
+  worst = DEFAULT_SPIN_NANOS / 10;
+  if(worst > MAX_SPIN_NANOS)
+  worst = MAX_SPIN_NANOS;
+  spinNanos = worst;
+}
 
-  timeradd(&currentTime, &delayLength, &endTime);
+void startClock()
+{
+  startNanos = monotonicNanos();
+  calibrateSpin();
+}
 
-  while(timercmp(&currentTime, &endTime, <))
-  gettimeofday(&currentTime, NULL);
+void delay(uint32_t duration)
+{
+  sleepUntil(monotonicNanos() + (uint64_t)duration * 1000000ULL);
 }
 
 void delayMicroseconds(uint32_t duration)
 {
-  struct timeval currentTime, delayLength, endTime;
-
-  gettimeofday(&currentTime, NULL);
+  sleepUntil(monotonicNanos() + (uint64_t)duration * 1000ULL);
+}
 
-  delayLength.tv_sec  = duration / 1000000;
-  delayLength.tv_usec = duration % 1000000;  
+uint64_t nanos()
+{
+  return monotonicNanos() - startNanos;
+}
 
-  timeradd(&currentTime, &delayLength, &endTime);
+uint64_t micros64()
+{
+  return nanos() / 1000ULL;
+}
 
-  while(timercmp(&currentTime, &endTime, <))
-  gettimeofday(&currentTime, NULL);
+uint64_t millis64()
+{
+  return nanos() / 1000000ULL;
 }
 
 uint32_t millis()
 {
-  struct timeval currentTime;
-
-  gettimeofday(&currentTime,  NULL);
-
-  return((uint32_t)( ((uint64_t)currentTime.tv_sec * (uint64_t)1000 + (uint64_t)(currentTime.tv_usec / 1000)) - startMillis));
+  return (uint32_t)millis64();
 }
 
 uint32_t micros()
 {
-  struct timeval currentTime;
-
-  gettimeofday(&currentTime,  NULL);
-
-  return((uint32_t)( ((uint64_t)currentTime.tv_sec * (uint64_t)1000000 + (uint64_t)currentTime.tv_usec) - startMicros));
-}
\ No newline at end of file
+  return (uint32_t)micros64();
+}
@@ -24,10 +24,14 @@
 #include <sys/time.h>
 #include <stdint.h>
 
+// All times are CLOCK_MONOTONIC since startClock(), unaffected by wall clock steps
 void startClock();
 void delay(uint32_t duration);
 void delayMicroseconds(uint32_t duration);
 uint32_t millis();
 uint32_t micros();
+uint64_t millis64();
+uint64_t micros64();
+uint64_t nanos();
 
 #endif 
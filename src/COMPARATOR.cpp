@@ -0,0 +1,198 @@
+/*
+    This file is a part of the wiringBone library
+    Background threshold and window comparators on ADC channels
+*/
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <sys/eventfd.h>
+#include "COMPARATOR.h"
+
+AnalogComparator::AnalogComparator(const char *device, const char *chardev)
+    : scan(device, chardev),
+      droppedCount(0),
+      stopFlag(false),
+      notifyFd(-1) {
+    scan.setSamplePeriod(COMPARATOR_SAMPLE_PERIOD);
+}
+
+AnalogComparator::~AnalogComparator() {
+    end();
+    if (notifyFd >= 0) {
+        close(notifyFd);
+    }
+}
+
+int AnalogComparator::addThreshold(adcPin pin, float low, float high) {
+    if (low > high) {
+        std::swap(low, high);
+    }
+    rules.push_back(Rule{compareThreshold, pin, low, high, 0.0f, false, false});
+    return rules.size() - 1;
+}
+
+int AnalogComparator::addWindow(adcPin pin, float low, float high, float hysteresis) {
+    if (low > high) {
+        std::swap(low, high);
+    }
+    rules.push_back(Rule{compareWindow, pin, low, high, hysteresis < 0.0f ? 0.0f : hysteresis, false, false});
+    return rules.size() - 1;
+}
+
+void AnalogComparator::setFilter(adcPin pin, ADCFilterType type, uint16_t window, float alpha) {
+    scan.setFilter(pin, type, window, alpha);
+}
+
+int AnalogComparator::begin(EventHandler handler) {
+    end();
+
+    uint8_t channelMask = 0;
+    for (Rule &rule : rules) {
+        if ((unsigned)rule.pin >= ADC_CHANNEL_COUNT) {
+            fprintf(stderr, "Comparator: invalid ADC pin %d\n", (int)rule.pin);
+            return -1;
+        }
+        channelMask |= 1 << rule.pin;
+        rule.primed = false;
+    }
+    if (scan.begin(channelMask, COMPARATOR_BLOCK) < 0) {
+        return -1;
+    }
+
+    if (notifyFd < 0 && (notifyFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        perror("Comparator eventfd failed");
+        scan.end();
+        return -1;
+    }
+
+    this->handler = handler;
+    stopFlag = false;
+    sampler = std::thread(&AnalogComparator::run, this);
+    return 0;
+}
+
+void AnalogComparator::end() {
+    stopFlag = true;
+    if (sampler.joinable()) {
+        sampler.join();
+    }
+    scan.end();
+}
+
+int AnalogComparator::eventFd(void) {
+    if (notifyFd < 0 && (notifyFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        perror("Comparator eventfd failed");
+    }
+    return notifyFd;
+}
+
+bool AnalogComparator::nextEvent(AnalogEvent &event) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    if (events.empty()) {
+        uint64_t count;
+        // Clear the counter so the descriptor only polls readable while events wait
+        if (notifyFd >= 0 && read(notifyFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+            perror("Comparator eventfd read failed");
+        }
+        return false;
+    }
+    event = events.front();
+    events.pop_front();
+    return true;
+}
+
+bool AnalogComparator::state(int rule) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    return rule >= 0 && (size_t)rule < rules.size() ? rules[rule].state : false;
+}
+
+unsigned long AnalogComparator::dropped(void) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    return droppedCount;
+}
+
+// Returns true when the rule's state changes
+bool AnalogComparator::evaluate(Rule &rule, float value) {
+    bool next;
+    if (rule.type == compareThreshold) {
+        next = rule.state ? value >= rule.low : value > rule.high;
+    }
+    else if (rule.state) {
+        next = value >= rule.low - rule.hysteresis && value <= rule.high + rule.hysteresis;
+    }
+    else {
+        next = value >= rule.low && value <= rule.high;
+    }
+
+    if (!rule.primed) {
+        rule.primed = true;
+        rule.state = next;
+        return false;
+    }
+    if (next == rule.state) {
+        return false;
+    }
+    rule.state = next;
+    return true;
+}
+
+void AnalogComparator::emit(const AnalogEvent &event) {
+    if (handler) {
+        handler(event);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        if (events.size() >= COMPARATOR_QUEUE_LENGTH) {
+            events.pop_front();
+            droppedCount++;
+        }
+        events.push_back(event);
+    }
+    uint64_t one = 1;
+    if (write(notifyFd, &one, sizeof(one)) < 0) {
+        perror("Comparator notify failed");
+    }
+}
+
+// Rules only look at samples, so a quiet signal costs one pass per block and no wakeups elsewhere
+void AnalogComparator::run() {
+    std::vector<AnalogEvent> crossings;
+    unsigned long backoff = 0;
+
+    while (!stopFlag) {
+        size_t count = scan.read(COMPARATOR_BLOCK, 100);
+        if (count == 0) {
+            // A stopped stream or failing attribute returns at once, so wait longer after each miss
+            backoff = backoff ? std::min<unsigned long>(backoff * 2, COMPARATOR_BACKOFF_MAX) : 1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+            continue;
+        }
+        backoff = 0;
+
+        const int64_t *stamps = scan.timestamps();
+        crossings.clear();
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            for (size_t index = 0; index < rules.size(); index++) {
+                Rule &rule = rules[index];
+                const float *values = scan.filtered(rule.pin);
+                for (size_t sample = 0; sample < count; sample++) {
+                    if (evaluate(rule, values[sample])) {
+                        crossings.push_back(AnalogEvent{(int)index, rule.pin, rule.state, values[sample], stamps[sample]});
+                    }
+                }
+            }
+        }
+        // Rules are evaluated one after another; deliver their crossings in sample order
+        std::stable_sort(crossings.begin(), crossings.end(),
+                         [](const AnalogEvent &a, const AnalogEvent &b) { return a.timestamp < b.timestamp; });
+        for (const AnalogEvent &event : crossings) {
+            emit(event);
+        }
+    }
+}
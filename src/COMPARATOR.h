@@ -0,0 +1,81 @@
+/*
+    This file is a part of the wiringBone library
+    Background threshold and window comparators on ADC channels
+*/
+
+#ifndef COMPARATOR_H
+#define COMPARATOR_H
+
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "ADCSCAN.h"
+
+#define COMPARATOR_BLOCK 64             // Scans evaluated per pass, bounds event latency
+#define COMPARATOR_QUEUE_LENGTH 256     // Events kept for eventFd() readers
+#define COMPARATOR_SAMPLE_PERIOD 1000   // us between scans when only raw attributes can be read
+#define COMPARATOR_BACKOFF_MAX 500      // ms, longest wait after repeated failed reads
+
+typedef enum { compareThreshold, compareWindow } CompareType;
+
+struct AnalogEvent {
+    int rule;
+    adcPin pin;
+    bool state;         // Threshold: above. Window: inside
+    float value;        // Filtered sample that crossed
+    int64_t timestamp;  // CLOCK_MONOTONIC ns of that sample
+};
+
+class AnalogComparator {
+public:
+    typedef std::function<void(const AnalogEvent &event)> EventHandler;
+
+    explicit AnalogComparator(const char *device = ADC_IIO_DEVICE, const char *chardev = ADC_IIO_CHARDEV);
+    ~AnalogComparator();
+
+    // Rules and filters are set up before begin()
+    // State turns true above high and false again below low, low <= high. Returns the rule id
+    int addThreshold(adcPin pin, float low, float high);
+    // State is true inside [low, high]; leaving needs hysteresis counts beyond either edge
+    int addWindow(adcPin pin, float low, float high, float hysteresis = 0.0f);
+    void setFilter(adcPin pin, ADCFilterType type, uint16_t window = 8, float alpha = 0.1f);
+
+    // The handler runs on the sampling thread and should return quickly
+    int begin(EventHandler handler = nullptr);
+    void end();
+
+    // Readable (eventfd counter) whenever events are queued; drain them with nextEvent()
+    int eventFd(void);
+    bool nextEvent(AnalogEvent &event);
+    bool state(int rule);
+    unsigned long dropped(void);        // Events lost because the queue was full
+
+private:
+    struct Rule {
+        CompareType type;
+        adcPin pin;
+        float low, high, hysteresis;
+        bool state;
+        bool primed;                    // First sample sets the state without an event
+    };
+
+    ADCScan scan;
+    std::vector<Rule> rules;
+    EventHandler handler;
+    std::deque<AnalogEvent> events;
+    std::mutex eventMutex;
+    unsigned long droppedCount;
+    std::atomic<bool> stopFlag;
+    std::thread sampler;
+    int notifyFd;
+
+    bool evaluate(Rule &rule, float value);
+    void emit(const AnalogEvent &event);
+    void run();
+};
+
+#endif
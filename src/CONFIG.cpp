@@ -0,0 +1,235 @@
+/*
+    This file is a part of the wiringBone library
+    Log-structured key-value store in the virtual EEPROM
+*/
+
+#include <string.h>
+#include <iostream>
+#include "CONFIG.h"
+
+#define CONFIG_RECORD_HEADER 8          // keyLength, valueLength, flags, reserved, crc32
+#define CONFIG_RECORD_REMOVED 0x01      // Tombstone, the key has no value from here on
+#define CONFIG_ERASED 0xff
+
+static size_t recordSize(size_t keyLength, size_t valueLength)
+{
+    return CONFIG_RECORD_HEADER + keyLength + valueLength;
+}
+
+static size_t encode(uint8_t *record, const std::string &key, const void *value, size_t valueLength, uint8_t flags)
+{
+    record[0] = key.size();
+    record[1] = valueLength;
+    record[2] = flags;
+    record[3] = 0;
+    memcpy(record + CONFIG_RECORD_HEADER, key.data(), key.size());
+    if (valueLength) {
+        memcpy(record + CONFIG_RECORD_HEADER + key.size(), value, valueLength);
+    }
+
+    uint32_t crc = eeprom_crc32(0, record, 4);
+    crc = eeprom_crc32(crc, record + CONFIG_RECORD_HEADER, key.size() + valueLength);
+    memcpy(record + 4, &crc, sizeof(crc));
+    return recordSize(key.size(), valueLength);
+}
+
+ConfigStore::ConfigStore(uint16_t base, uint16_t length)
+    : base(base),
+      length(length),
+      loaded(false),
+      tail(0),
+      liveBytes(0) {
+}
+
+bool ConfigStore::begin(void) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return load();
+}
+
+// One block read of the region, then a single pass that keeps the newest record per key
+bool ConfigStore::load(void) {
+    if (loaded) {
+        return true;
+    }
+    if (base + length > E2END + 1) {
+        std::cerr << "Config store does not fit in EEPROM" << std::endl;
+        return false;
+    }
+    log.resize(length);
+    eeprom_read_block(log.data(), (const void*) (intptr_t) base, length);
+
+    index.clear();
+    liveBytes = 0;
+    tail = 0;
+    while (tail + CONFIG_RECORD_HEADER <= length) {
+        const uint8_t *record = &log[tail];
+        size_t keyLength = record[0], valueLength = record[1];
+
+        // Erased space ends the log, and so does a record that never finished writing
+        if (keyLength == 0 || keyLength > CONFIG_KEY_MAX || valueLength > CONFIG_VALUE_MAX) {
+            break;
+        }
+        size_t size = recordSize(keyLength, valueLength);
+        if (tail + size > length) {
+            break;
+        }
+        uint32_t crc, stored;
+        crc = eeprom_crc32(0, record, 4);
+        crc = eeprom_crc32(crc, record + CONFIG_RECORD_HEADER, keyLength + valueLength);
+        memcpy(&stored, record + 4, sizeof(stored));
+        if (crc != stored) {
+            std::cerr << "Config store record at " << tail << " is corrupt, dropping the rest of the log" << std::endl;
+            break;
+        }
+
+        std::string key((const char*) record + CONFIG_RECORD_HEADER, keyLength);
+        update(key, tail, record + CONFIG_RECORD_HEADER + keyLength, valueLength, record[2]);
+        tail += size;
+    }
+    loaded = true;
+    return true;
+}
+
+void ConfigStore::update(const std::string &key, size_t offset, const void *value, size_t valueLength, uint8_t flags) {
+    auto existing = index.find(key);
+    if (existing != index.end()) {
+        liveBytes -= recordSize(key.size(), existing->second.value.size());
+        if (flags & CONFIG_RECORD_REMOVED) {
+            index.erase(existing);
+            return;
+        }
+        existing->second.offset = offset;
+        existing->second.value.assign((const char*) value, valueLength);
+    } else if (flags & CONFIG_RECORD_REMOVED) {
+        return;
+    } else {
+        index.emplace(key, Entry{(uint16_t) offset, std::string((const char*) value, valueLength)});
+    }
+    liveBytes += recordSize(key.size(), valueLength);
+}
+
+bool ConfigStore::append(const std::string &key, const void *value, size_t valueLength, uint8_t flags) {
+    size_t size = recordSize(key.size(), valueLength);
+    if (tail + size > length) {
+        return rewrite(&key, value, valueLength, flags);
+    }
+    encode(&log[tail], key, value, valueLength, flags);
+    eeprom_update_block(&log[tail], (void*) (intptr_t) (base + tail), size);
+    update(key, tail, value, valueLength, flags);
+    tail += size;
+    return true;
+}
+
+// Writes the live records, plus an optional change to key, from the start of the region.
+// It goes to EEPROM as one block so a commit never sees half of it
+bool ConfigStore::rewrite(const std::string *key, const void *value, size_t valueLength, uint8_t flags) {
+    std::vector<uint8_t> fresh(length, CONFIG_ERASED);
+    std::vector<std::pair<Entry*, size_t>> offsets;
+    size_t end = 0;
+
+    offsets.reserve(index.size());
+    for (auto &entry : index) {
+        if (key && entry.first == *key) {
+            continue;
+        }
+        size_t size = recordSize(entry.first.size(), entry.second.value.size());
+        if (end + size > length) {
+            return false;
+        }
+        offsets.emplace_back(&entry.second, end);
+        end += encode(&fresh[end], entry.first, entry.second.value.data(), entry.second.value.size(), 0);
+    }
+    size_t keyOffset = end;
+    if (key && !(flags & CONFIG_RECORD_REMOVED)) {
+        if (end + recordSize(key->size(), valueLength) > length) {
+            std::cerr << "Config store is full" << std::endl;
+            return false;
+        }
+        end += encode(&fresh[end], *key, value, valueLength, 0);
+    }
+
+    // Erased bytes over the old tail keep stale records from being replayed
+    eeprom_update_block(fresh.data(), (void*) (intptr_t) base, end > tail ? end : tail);
+    log.swap(fresh);
+    for (auto &moved : offsets) {
+        moved.first->offset = moved.second;
+    }
+    if (key) {
+        update(*key, keyOffset, value, valueLength, flags);
+    }
+    tail = end;
+    return true;
+}
+
+bool ConfigStore::get(const char *key, void *value, size_t valueLength) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!load()) {
+        return false;
+    }
+    auto entry = index.find(key);
+    if (entry == index.end() || entry->second.value.size() != valueLength) {
+        return false;
+    }
+    memcpy(value, entry->second.value.data(), valueLength);
+    return true;
+}
+
+bool ConfigStore::put(const char *key, const void *value, size_t valueLength) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    size_t keyLength = strlen(key);
+    if (keyLength == 0 || keyLength > CONFIG_KEY_MAX || valueLength > CONFIG_VALUE_MAX) {
+        std::cerr << "Config key or value too long: " << key << std::endl;
+        return false;
+    }
+    if (!load()) {
+        return false;
+    }
+    std::string name(key, keyLength);
+    auto entry = index.find(name);
+    // Unchanged values cost no EEPROM wear
+    if (entry != index.end() && entry->second.value.size() == valueLength &&
+        memcmp(entry->second.value.data(), value, valueLength) == 0) {
+        return true;
+    }
+    return append(name, value, valueLength, 0);
+}
+
+bool ConfigStore::remove(const char *key) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!load()) {
+        return false;
+    }
+    std::string name(key);
+    if (index.find(name) == index.end()) {
+        return false;
+    }
+    return append(name, NULL, 0, CONFIG_RECORD_REMOVED);
+}
+
+bool ConfigStore::contains(const char *key) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return load() && index.find(key) != index.end();
+}
+
+bool ConfigStore::compact(void) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return load() && rewrite(NULL, NULL, 0, 0);
+}
+
+size_t ConfigStore::used(void) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    load();
+    return tail;
+}
+
+size_t ConfigStore::live(void) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    load();
+    return liveBytes;
+}
+
+ConfigStore *configStore()
+{
+  static ConfigStore store;
+  return &store;
+}
@@ -0,0 +1,74 @@
+/*
+    This file is a part of the wiringBone library
+    Log-structured key-value store in the virtual EEPROM
+*/
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include "EEPROM.h"
+
+#define CONFIG_BASE 2048                // EEPROM bytes below this stay free for sketches
+#define CONFIG_LENGTH (E2END + 1 - CONFIG_BASE)
+#define CONFIG_KEY_MAX 32
+#define CONFIG_VALUE_MAX 128
+
+// Records are appended to the region and the newest one per key wins. A RAM
+// index answers lookups, and the log is rewritten once it runs out of room
+class ConfigStore {
+public:
+    ConfigStore(uint16_t base = CONFIG_BASE, uint16_t length = CONFIG_LENGTH);
+
+    bool begin(void);                   // Loads the index, done on first use otherwise
+
+    // False if the key is missing or was stored with a different length
+    bool get(const char *key, void *value, size_t length);
+    bool put(const char *key, const void *value, size_t length);
+    bool remove(const char *key);
+    bool contains(const char *key);
+
+    template <typename T> bool get(const char *key, T &value) { return get(key, &value, sizeof(T)); }
+    template <typename T> bool put(const char *key, const T &value) { return put(key, &value, sizeof(T)); }
+
+    // Reads the key, or returns fallback without storing it so defaults cost no EEPROM space
+    template <typename T> T value(const char *key, const T &fallback) {
+        T result;
+        return get(key, result) ? result : fallback;
+    }
+
+    bool compact(void);                 // Drops superseded and removed records
+    size_t used(void);                  // Log bytes, including superseded records
+    size_t live(void);                  // Bytes a compacted log would need
+    size_t size(void) { return length; }
+
+private:
+    struct Entry {
+        uint16_t offset;                // Record holding the current value
+        std::string value;
+    };
+
+    uint16_t base;
+    uint16_t length;
+    bool loaded;
+    std::vector<uint8_t> log;           // RAM copy of the region
+    size_t tail;                        // First free byte in log
+    size_t liveBytes;
+    std::unordered_map<std::string, Entry> index;
+    std::mutex storeMutex;
+
+    bool load(void);
+    bool append(const std::string &key, const void *value, size_t valueLength, uint8_t flags);
+    bool rewrite(const std::string *key, const void *value, size_t valueLength, uint8_t flags);
+    void update(const std::string &key, size_t offset, const void *value, size_t valueLength, uint8_t flags);
+};
+
+// Shared store for the library and the parking system
+ConfigStore *configStore();
+
+#endif
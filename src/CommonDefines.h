@@ -34,6 +34,7 @@ extern void cli(); // Disable interrupts (not used in this system)
 #define CONTROL      0x0   // Control register offset
 #define SOFT_RST_N   0     // Soft reset bit
 #define ENABLE       1     // Enable bit
+#define RUNSTATE     15    // Running state bit (read only)
 
 // IEP Register Definitions
 #define GLOBAL_CFG   0x0   // Global configuration register offset
@@ -0,0 +1,426 @@
+/*
+    This file is a part of the wiringBone library
+    Virtual EEPROM in an mmapped file with double-buffered, batched commits
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <libgen.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "EEPROM.h"
+#include "TIMER.h"
+
+#define EEPROM_SIZE (E2END + 1)
+#define EEPROM_MAGIC 0x45455632         // "EEV2"
+#define EEPROM_ERASED 0xff
+#define EEPROM_TEMP_FILE EEPROM_FILE ".tmp"
+
+// Closes each bank, on its own page so a commit only rewrites the page it owns
+struct BankHeader {
+    uint32_t magic;
+    uint32_t crc;                       // Over the sequence and the bank data
+    uint64_t sequence;                  // Highest valid sequence is the current bank
+};
+
+class VirtualEEPROM {
+public:
+    VirtualEEPROM();
+    ~VirtualEEPROM();
+
+    void read(void *dst, size_t address, size_t length);
+    void write(const void *src, size_t address, size_t length);
+    int commit(void);
+    void setInterval(uint32_t interval_ms);
+
+private:
+    uint8_t *base;
+    size_t mapLength;
+    size_t bankLength;                  // Data rounded up to a page, then the header page
+    size_t dataLength;
+    bool persistent;                    // False after falling back to anonymous memory
+    int fd;
+
+    int active;                         // Bank holding the last committed contents
+    uint64_t sequence;
+    bool stagingFresh;                  // The other bank mirrors active plus pending writes
+    bool dirty;
+    bool closed;
+    TimerId commitTimer;
+    std::mutex storeMutex;
+
+    // The wheel only flags a commit, the blocking msync calls run on the committer thread
+    std::thread committer;
+    std::mutex commitMutex;
+    std::condition_variable commitCv;
+    bool commitRequested;
+    bool stopping;
+
+    uint8_t *data(int bank) { return base + bank * bankLength; }
+    BankHeader *header(int bank) { return (BankHeader*) (data(bank) + dataLength); }
+    bool valid(int bank);
+    void seal(int bank, uint64_t seq);
+    bool open(void);
+    int commitLocked(void);
+    void requestCommit(void);
+    void runCommitter(void);
+};
+
+VirtualEEPROM::VirtualEEPROM()
+    : base(NULL),
+      mapLength(0),
+      bankLength(0),
+      dataLength(0),
+      persistent(false),
+      fd(-1),
+      active(0),
+      sequence(0),
+      stagingFresh(false),
+      dirty(false),
+      closed(false),
+      commitTimer(0),
+      commitRequested(false),
+      stopping(false) {
+    size_t page = sysconf(_SC_PAGESIZE);
+
+    dataLength = (EEPROM_SIZE + page - 1) / page * page;
+    bankLength = dataLength + page;
+    mapLength = 2 * bankLength;
+
+    if (!open()) {
+        // Keep the sketch running on volatile storage rather than failing every access
+        std::cerr << "Virtual EEPROM is not persistent, using memory only" << std::endl;
+        base = (uint8_t*) mmap(NULL, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            perror("Virtual EEPROM allocation failed");
+            base = NULL;
+            return;
+        }
+        memset(data(0), EEPROM_ERASED, dataLength);
+        seal(0, 1);
+    }
+    committer = std::thread(&VirtualEEPROM::runCommitter, this);
+    setInterval(EEPROM_COMMIT_INTERVAL);
+}
+
+VirtualEEPROM::~VirtualEEPROM() {
+    TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        timer = commitTimer;
+        commitTimer = 0;
+    }
+    if (timer) {
+        timerWheel()->cancelAndWait(timer);
+    }
+    {
+        std::lock_guard<std::mutex> lock(commitMutex);
+        stopping = true;
+    }
+    commitCv.notify_one();
+    // Joined without the lock, a commit already running on the committer needs it to finish
+    if (committer.joinable()) {
+        committer.join();
+    }
+
+    std::lock_guard<std::mutex> lock(storeMutex);
+    commitLocked();
+    closed = true;
+    if (base) {
+        munmap(base, mapLength);
+        base = NULL;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool VirtualEEPROM::valid(int bank) {
+    BankHeader *bankHeader = header(bank);
+    if (bankHeader->magic != EEPROM_MAGIC) {
+        return false;
+    }
+    uint32_t crc = eeprom_crc32(0, (const uint8_t*) &bankHeader->sequence, sizeof(bankHeader->sequence));
+    return eeprom_crc32(crc, data(bank), EEPROM_SIZE) == bankHeader->crc;
+}
+
+void VirtualEEPROM::seal(int bank, uint64_t seq) {
+    BankHeader *bankHeader = header(bank);
+    uint32_t crc = eeprom_crc32(0, (const uint8_t*) &seq, sizeof(seq));
+    bankHeader->sequence = seq;
+    bankHeader->crc = eeprom_crc32(crc, data(bank), EEPROM_SIZE);
+    bankHeader->magic = EEPROM_MAGIC;
+    active = bank;
+    sequence = seq;
+}
+
+// A rename only survives a power cut once the directory holding it is synced
+static int syncDirectory(const char *path)
+{
+    char copy[256];
+    int result, directory;
+
+    snprintf(copy, sizeof(copy), "%s", path);
+    if ((directory = ::open(dirname(copy), O_RDONLY | O_DIRECTORY | O_CLOEXEC)) < 0) {
+        return -1;
+    }
+    result = fsync(directory);
+    close(directory);
+    return result;
+}
+
+bool VirtualEEPROM::open(void) {
+    struct stat status;
+    uint8_t legacy[EEPROM_SIZE];
+    ssize_t legacyLength = 0;
+    bool migrating = false;
+
+    if ((fd = ::open(EEPROM_FILE, O_RDWR | O_CREAT | O_CLOEXEC, 0644)) < 0) {
+        perror("Unable to open Virtual EEPROM file");
+        return false;
+    }
+    if (fstat(fd, &status) < 0) {
+        perror("Unable to read Virtual EEPROM file size");
+        goto fail;
+    }
+
+    // Anything up to the old 1024 byte raw image is carried over into bank 0 of a new
+    // file, which replaces the old one only once it is complete on disk
+    if ((size_t) status.st_size != mapLength) {
+        if (status.st_size > EEPROM_SIZE) {
+            std::cerr << "Virtual EEPROM file has unexpected size " << status.st_size << std::endl;
+            goto fail;
+        }
+        if ((legacyLength = pread(fd, legacy, status.st_size, 0)) < 0) {
+            perror("Unable to read Virtual EEPROM file");
+            goto fail;
+        }
+        close(fd);
+        migrating = true;
+        if ((fd = ::open(EEPROM_TEMP_FILE, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0) {
+            perror("Unable to create Virtual EEPROM file");
+            goto fail;
+        }
+        if (ftruncate(fd, mapLength) < 0) {
+            perror("Unable to size Virtual EEPROM file");
+            goto fail;
+        }
+    }
+
+    base = (uint8_t*) mmap(NULL, mapLength, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        perror("Unable to map Virtual EEPROM file");
+        base = NULL;
+        goto fail;
+    }
+
+    if (migrating) {
+        memset(data(0), EEPROM_ERASED, dataLength);
+        memcpy(data(0), legacy, legacyLength);
+        seal(0, 1);
+        if (msync(base, mapLength, MS_SYNC) < 0 || fsync(fd) < 0 || rename(EEPROM_TEMP_FILE, EEPROM_FILE) < 0) {
+            perror("Virtual EEPROM migration failed");
+            munmap(base, mapLength);
+            base = NULL;
+            goto fail;
+        }
+        migrating = false;
+        if (syncDirectory(EEPROM_FILE) < 0) {
+            perror("Virtual EEPROM directory sync failed");
+        }
+    } else {
+        // A torn commit leaves its bank without a valid header, so the other one wins
+        bool valid0 = valid(0), valid1 = valid(1);
+        if (valid0 && (!valid1 || header(0)->sequence > header(1)->sequence)) {
+            active = 0;
+        } else if (valid1) {
+            active = 1;
+        } else {
+            std::cerr << "Virtual EEPROM file is corrupt, erasing" << std::endl;
+            memset(data(0), EEPROM_ERASED, dataLength);
+            seal(0, 1);
+            msync(base, mapLength, MS_SYNC);
+        }
+        sequence = header(active)->sequence;
+    }
+    persistent = true;
+    return true;
+
+fail:
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (migrating) {
+        unlink(EEPROM_TEMP_FILE);
+    }
+    fd = -1;
+    return false;
+}
+
+void VirtualEEPROM::read(void *dst, size_t address, size_t length) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!base || address >= EEPROM_SIZE) {
+        memset(dst, 0, length);
+        return;
+    }
+    if (length > EEPROM_SIZE - address) {
+        memset((uint8_t*) dst + EEPROM_SIZE - address, 0, length - (EEPROM_SIZE - address));
+        length = EEPROM_SIZE - address;
+    }
+    memcpy(dst, data(stagingFresh ? 1 - active : active) + address, length);
+}
+
+void VirtualEEPROM::write(const void *src, size_t address, size_t length) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (!base || address >= EEPROM_SIZE) {
+        return;
+    }
+    if (length > EEPROM_SIZE - address) {
+        length = EEPROM_SIZE - address;
+    }
+
+    uint8_t *staging = data(1 - active);
+    if (!stagingFresh) {
+        if (memcmp(data(active) + address, src, length) == 0) {
+            return;
+        }
+        memcpy(staging, data(active), EEPROM_SIZE);
+        stagingFresh = true;
+    }
+    if (memcmp(staging + address, src, length) != 0) {
+        memcpy(staging + address, src, length);
+        dirty = true;
+    }
+}
+
+int VirtualEEPROM::commit(void) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return closed ? 0 : commitLocked();
+}
+
+void VirtualEEPROM::requestCommit(void) {
+    {
+        std::lock_guard<std::mutex> lock(commitMutex);
+        commitRequested = true;
+    }
+    commitCv.notify_one();
+}
+
+void VirtualEEPROM::runCommitter(void) {
+    std::unique_lock<std::mutex> lock(commitMutex);
+    while (true) {
+        commitCv.wait(lock, [this] { return commitRequested || stopping; });
+        if (stopping) {
+            break;
+        }
+        commitRequested = false;
+        lock.unlock();
+        commit();
+        lock.lock();
+    }
+}
+
+int VirtualEEPROM::commitLocked(void) {
+    if (!dirty) {
+        return 0;
+    }
+    int staging = 1 - active;
+    size_t page = bankLength - dataLength;
+
+    // Data reaches the disk before the header that vouches for it
+    if (persistent && msync(data(staging), dataLength, MS_SYNC) < 0) {
+        perror("Virtual EEPROM data sync failed");
+        return -1;
+    }
+    seal(staging, sequence + 1);
+    if (persistent && msync(header(staging), page, MS_SYNC) < 0) {
+        perror("Virtual EEPROM header sync failed");
+        return -1;
+    }
+    stagingFresh = false;
+    dirty = false;
+    return 0;
+}
+
+void VirtualEEPROM::setInterval(uint32_t interval_ms) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (commitTimer) {
+        timerWheel()->cancel(commitTimer);
+        commitTimer = 0;
+    }
+    if (interval_ms) {
+        commitTimer = timerWheel()->schedulePeriodic(interval_ms, [this] { requestCommit(); }, interval_ms);
+    }
+}
+
+EEPROMClass EEPROM;
+
+// Function local and built after the timer wheel, so it is destroyed first and commits on exit
+static VirtualEEPROM &store()
+{
+  timerWheel();
+  static VirtualEEPROM eeprom;
+  return eeprom;
+}
+
+uint8_t eeprom_read_byte(uint8_t* address)
+{
+  uint8_t x;
+  store().read(&x, (size_t) address, sizeof(x));
+  return x;
+}
+
+void eeprom_write_byte(uint8_t* address, uint8_t x)
+{
+  store().write(&x, (size_t) address, sizeof(x));
+}
+
+void eeprom_read_block(void *dst, const void *address, size_t n)
+{
+  store().read(dst, (size_t) address, n);
+}
+
+void eeprom_update_block(const void *src, void *address, size_t n)
+{
+  store().write(src, (size_t) address, n);
+}
+
+int eeprom_commit(void)
+{
+  return store().commit();
+}
+
+void eeprom_commit_interval(uint32_t interval_ms)
+{
+  store().setInterval(interval_ms);
+}
+
+// CRC-32 (IEEE), the table built on first use
+uint32_t eeprom_crc32(uint32_t crc, const void *data, size_t n)
+{
+  static uint32_t table[256];
+  static std::once_flag ready;
+  const uint8_t *bytes = (const uint8_t*) data;
+
+  std::call_once(ready, []
+  {
+    for(uint32_t index = 0; index < 256; index++)
+    {
+      uint32_t value = index;
+      for(int bit = 0; bit < 8; bit++)
+      value = (value >> 1) ^ (0xedb88320 & (0 - (value & 1)));
+      table[index] = value;
+    }
+  });
+  crc = ~crc;
+  while(n--)
+  crc = table[(crc ^ *bytes++) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
@@ -4,6 +4,8 @@
 //           Implemented eeprom_read_byte and eeprom_write_byte
 //           which will handle a virtual file in the filesystem.
 //           Define Max file size 1024 bytes
+//           Storage moved to EEPROM.cpp: an mmapped, double-buffered file
+//           with batched commits, 4096 bytes
 
 /*
   EEPROM.h - EEPROM library
@@ -29,46 +31,27 @@
 #define EEPROM_h
 
 #include <inttypes.h>
+#include <stddef.h>
 //#include <avr/eeprom.h>
 //#include <avr/io.h>
 
 #include <stdio.h>
 
-#define E2END 1023
-
-FILE *fp;
-
-void eeprom_file_open()
-{
-  fp = fopen("../VIRTUAL_EEPROM.bin", "r+b");  //to stop from overwritting to the file and preserve previous data
-  if (!fp)
-  {
-    printf("Unable to open Virtual EEPROM file,New EEPROM file has been created!");
-    fp = fopen("../VIRTUAL_EEPROM.bin", "w+b");  //to creat empty file
-    fclose(fp);
-    fp = fopen("../VIRTUAL_EEPROM.bin", "r+b");  //to stop from overwritting to the file and preserve previous data
-  }
-} 
-
-uint8_t eeprom_read_byte(uint8_t* address) /* read data from specific addess with 1 byte size*/
-{ 
-  uint8_t x;
-  eeprom_file_open();
-  rewind(fp);
-  fseek(fp, sizeof(x)*((int)address), SEEK_SET);
-  fread(&x, sizeof(x), 1, fp);
-  fclose(fp);
-  return x;
-}
-
-void eeprom_write_byte(uint8_t* address, uint8_t x) /* write data to specific addess with 1 byte size*/
-{
-  eeprom_file_open();
-  rewind(fp); 
-  fseek(fp, sizeof(x)*((int)address), SEEK_SET);
-  fwrite(&x, sizeof(x), 1, fp); 			
-  fclose(fp);
-}
+#define E2END 4095
+
+#define EEPROM_FILE "../VIRTUAL_EEPROM.bin"
+#define EEPROM_COMMIT_INTERVAL 1000     // ms between automatic commits of pending writes
+
+// The virtual EEPROM is an mmapped file holding two copies. Writes land in the copy
+// that is not current and become durable together at the next commit, so a power cut
+// leaves either every write before the commit or none of them.
+uint8_t eeprom_read_byte(uint8_t* address);
+void eeprom_write_byte(uint8_t* address, uint8_t x);
+void eeprom_read_block(void *dst, const void *address, size_t n);
+void eeprom_update_block(const void *src, void *address, size_t n);
+int eeprom_commit(void);                        // msyncs pending writes, 0 on success
+void eeprom_commit_interval(uint32_t interval_ms);  // 0 leaves commits to eeprom_commit()
+uint32_t eeprom_crc32(uint32_t crc, const void *data, size_t n);  // Checksum for records kept in EEPROM
 
 /***
     EERef class.
@@ -84,12 +67,12 @@ struct EERef{
         : index( index )                 {}
     
     //Access/read members.
-    uint8_t operator*() const            { return eeprom_read_byte( (uint8_t*) index ); }
+    uint8_t operator*() const            { return eeprom_read_byte( (uint8_t*) (intptr_t) index ); }
     operator const uint8_t() const       { return **this; }
     
     //Assignment/write members.
     EERef &operator=( const EERef &ref ) { return *this = *ref; }
-    EERef &operator=( uint8_t in )       { return eeprom_write_byte( (uint8_t*) index, in ), *this;  }
+    EERef &operator=( uint8_t in )       { return eeprom_write_byte( (uint8_t*) (intptr_t) index, in ), *this;  }
     EERef &operator +=( uint8_t in )     { return *this = **this + in; }
     EERef &operator -=( uint8_t in )     { return *this = **this - in; }
     EERef &operator *=( uint8_t in )     { return *this = **this * in; }
@@ -173,19 +156,19 @@ struct EEPROMClass{
     
     //Functionality to 'get' and 'put' objects to and from EEPROM.
     template< typename T > T &get( int idx, T &t ){
-        EEPtr e = idx;
-        uint8_t *ptr = (uint8_t*) &t;
-        for( int count = sizeof(T) ; count ; --count, ++e )  *ptr++ = *e;
+        eeprom_read_block( &t, (const void*) (intptr_t) idx, sizeof(T) );
         return t;
     }
     
     template< typename T > const T &put( int idx, const T &t ){
-        EEPtr e = idx;
-        const uint8_t *ptr = (const uint8_t*) &t;
-        for( int count = sizeof(T) ; count ; --count, ++e )  (*e).update( *ptr++ );
+        eeprom_update_block( &t, (void*) (intptr_t) idx, sizeof(T) );
         return t;
     }
+
+    //Durability control, writes are otherwise committed every EEPROM_COMMIT_INTERVAL ms.
+    bool commit()                        { return eeprom_commit() == 0; }
+    void setCommitInterval( uint32_t ms ) { eeprom_commit_interval( ms ); }
 };
 
-static EEPROMClass EEPROM;
+extern EEPROMClass EEPROM;
 #endif
\ No newline at end of file
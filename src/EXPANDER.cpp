@@ -0,0 +1,221 @@
+/*
+    This file is a part of the wiringBone library
+    Interrupt driven inputs on MCP23017 I2C GPIO expanders
+*/
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include "EXPANDER.h"
+#include "GPIO.h"
+
+ExpanderInputs::ExpanderInputs(int busNum)
+    : bus(i2cBus(busNum)),
+      stopFd(-1) {
+}
+
+ExpanderInputs::~ExpanderInputs() {
+    end();
+}
+
+int ExpanderInputs::addExpander(uint8_t address, uint8_t intGpio, uint16_t inputMask) {
+    expanders.push_back(Expander{address, intGpio, inputMask, 0});
+
+    size_t index = expanders.size() - 1;
+    for (IntLine &line : lines) {
+        if (line.gpio == intGpio) {
+            line.expanders.push_back(index);
+            return index;
+        }
+    }
+    lines.push_back(IntLine{intGpio, -1, {index}});
+    return index;
+}
+
+// One burst from IODIRA: direction, polarity, interrupt enable, compare values, IOCON and pull-ups
+int ExpanderInputs::configure(Expander &expander) {
+    uint8_t lo = expander.inputMask & 0xff;
+    uint8_t hi = expander.inputMask >> 8;
+    uint8_t iocon = MCP23017_IOCON_MIRROR | MCP23017_IOCON_ODR;
+    std::vector<uint8_t> config = {
+        MCP23017_IODIRA,
+        lo, hi,         // IODIR: masked pins are inputs
+        0, 0,           // IPOL
+        lo, hi,         // GPINTEN: interrupt on change for inputs
+        0, 0,           // DEFVAL
+        0, 0,           // INTCON: compare against the previous value
+        iocon, iocon,   // IOCON
+        lo, hi          // GPPU
+    };
+
+    if (bus->transfer(expander.address, config, 0).status != 0) {
+        perror("Expander configuration failed");
+        return -1;
+    }
+    return 0;
+}
+
+// Reads INTF, INTCAP and GPIO in one combined transfer, which also clears the interrupt
+int ExpanderInputs::service(size_t index) {
+    Expander &expander = expanders[index];
+    I2CResult result = bus->transfer(expander.address, {MCP23017_INTFA}, 6, i2cCritical);
+
+    if (result.status != 0) {
+        return -1;
+    }
+
+    const uint8_t *regs = result.data.data();
+    uint16_t flagged = (regs[0] | (regs[1] << 8)) & expander.inputMask;
+    uint16_t captured = regs[2] | (regs[3] << 8);
+    uint16_t current = (regs[4] | (regs[5] << 8)) & expander.inputMask;
+    int changed = 0;
+
+    // INTCAP holds the flagged pins as they were at the interrupt, so a pulse
+    // that ended before this read still reports both of its edges
+    if (flagged) {
+        changed |= report(index, (expander.state & ~flagged) | (captured & flagged));
+    }
+    changed |= report(index, current);
+    return changed;
+}
+
+int ExpanderInputs::report(size_t index, uint16_t value) {
+    uint16_t changed;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        changed = value ^ expanders[index].state;
+        expanders[index].state = value;
+    }
+    if (changed && handler) {
+        handler(index, value, changed);
+    }
+    return changed != 0;
+}
+
+int ExpanderInputs::openLine(IntLine &line) {
+    FILE *fd;
+    char path[40];
+
+    if (gpioInstance()->gpioConfig(line.gpio, INPUT) < 0) {
+        return -1;
+    }
+
+    sprintf(path, "/sys/class/gpio/gpio%d/edge", line.gpio);
+    if ((fd = fopen(path, "w")) == NULL) {
+        perror("Expander INT edge setup failed");
+        return -1;
+    }
+    fprintf(fd, "falling");
+    fclose(fd);
+
+    sprintf(path, "/sys/class/gpio/gpio%d/value", line.gpio);
+    if ((line.fd = open(path, O_RDONLY | O_NONBLOCK)) < 0) {
+        perror("Expander INT open failed");
+        return -1;
+    }
+    return 0;
+}
+
+int ExpanderInputs::begin(ChangeHandler handler) {
+    end();
+    this->handler = handler;
+
+    for (Expander &expander : expanders) {
+        if (configure(expander) < 0) {
+            return -1;
+        }
+    }
+    for (IntLine &line : lines) {
+        if (openLine(line) < 0) {
+            return -1;
+        }
+    }
+
+    if ((stopFd = eventfd(0, 0)) < 0) {
+        perror("Expander eventfd failed");
+        return -1;
+    }
+    watcher = std::thread(&ExpanderInputs::run, this);
+    return 0;
+}
+
+void ExpanderInputs::end() {
+    if (watcher.joinable()) {
+        uint64_t one = 1;
+        if (write(stopFd, &one, sizeof(one)) < 0) {
+            perror("Expander stop failed");
+        }
+        watcher.join();
+    }
+    if (stopFd >= 0) {
+        close(stopFd);
+        stopFd = -1;
+    }
+    for (IntLine &line : lines) {
+        if (line.fd >= 0) {
+            close(line.fd);
+            line.fd = -1;
+        }
+    }
+}
+
+uint16_t ExpanderInputs::state(size_t index) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return index < expanders.size() ? expanders[index].state : 0;
+}
+
+// Reads the expanders sharing the line until it is released. Returns true if it is still held low
+bool ExpanderInputs::serviceLine(IntLine &line) {
+    char value[4];
+
+    for (int pass = 0; pass < EXPANDER_MAX_PASSES; pass++) {
+        // The read also acknowledges the edge sysfs reported
+        if (pread(line.fd, value, sizeof(value), 0) <= 0 || value[0] != '0') {
+            return false;
+        }
+        for (size_t expander : line.expanders) {
+            service(expander);
+        }
+    }
+    return pread(line.fd, value, sizeof(value), 0) > 0 && value[0] == '0';
+}
+
+void ExpanderInputs::run() {
+    std::vector<struct pollfd> fds(lines.size() + 1);
+
+    for (size_t index = 0; index < lines.size(); index++) {
+        fds[index].fd = lines[index].fd;
+        fds[index].events = POLLPRI | POLLERR;
+    }
+    fds[lines.size()].fd = stopFd;
+    fds[lines.size()].events = POLLIN;
+
+    // Done here so the handler only ever runs on this thread. It also picks up an INT
+    // already asserted before the edge was armed, which would never produce an edge
+    for (size_t index = 0; index < expanders.size(); index++) {
+        service(index);
+    }
+
+    while (true) {
+        // Every line is checked by level, not only the one that fired. A line that fell
+        // before its edge was armed, or is still held after the passes, makes no new edge
+        bool asserted = false;
+        for (IntLine &line : lines) {
+            asserted = serviceLine(line) || asserted;
+        }
+
+        if (poll(fds.data(), fds.size(), asserted ? EXPANDER_RETRY_MS : -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Expander poll failed");
+            return;
+        }
+        if (fds[lines.size()].revents & POLLIN) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+    This file is a part of the wiringBone library
+    Interrupt driven inputs on MCP23017 I2C GPIO expanders
+*/
+
+#ifndef EXPANDER_H
+#define EXPANDER_H
+
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include "I2CBus.h"
+
+// MCP23017 registers with IOCON.BANK = 0, A/B ports interleaved
+#define MCP23017_IODIRA   0x00
+#define MCP23017_GPINTENA 0x04
+#define MCP23017_IOCON    0x0a
+#define MCP23017_INTFA    0x0e
+#define MCP23017_GPIOA    0x12
+
+#define MCP23017_IOCON_MIRROR 0x40  // INTA and INTB act as one line
+#define MCP23017_IOCON_ODR    0x04  // Open drain INT so expanders can share a gpio
+
+#define EXPANDER_MAX_PASSES 8       // Re-reads of a shared INT line that stays asserted
+#define EXPANDER_RETRY_MS 10        // Poll period while a line is held low past the passes
+
+class ExpanderInputs {
+public:
+    // Called from the watcher thread with the new port state (B in the high byte) and the bits that changed
+    typedef std::function<void(size_t index, uint16_t state, uint16_t changed)> ChangeHandler;
+
+    // Transfers are queued on the shared scheduler of /dev/i2c-busNum, the one Wire uses too
+    explicit ExpanderInputs(int busNum = 1);
+    ~ExpanderInputs();
+
+    // intGpio is the BeagleBone gpio wired to the expander INT pin, returns the expander index
+    int addExpander(uint8_t address, uint8_t intGpio, uint16_t inputMask = 0xffff);
+    int begin(ChangeHandler handler);   // Configures every expander and starts watching INT lines
+    void end();
+
+    uint16_t state(size_t index);
+
+private:
+    struct Expander {
+        uint8_t address;
+        uint8_t intGpio;
+        uint16_t inputMask;
+        uint16_t state;
+    };
+
+    struct IntLine {
+        uint8_t gpio;
+        int fd;                         // Open sysfs value file, polled for POLLPRI
+        std::vector<size_t> expanders;  // Open drain INT lines may be shared
+    };
+
+    I2CBus *bus;
+    std::vector<Expander> expanders;
+    std::vector<IntLine> lines;
+    ChangeHandler handler;
+    std::mutex stateMutex;
+    std::thread watcher;
+    int stopFd;
+
+    int configure(Expander &expander);
+    int service(size_t index);
+    int report(size_t index, uint16_t value);
+    bool serviceLine(IntLine &line);
+    int openLine(IntLine &line);
+    void run();
+};
+
+#endif
@@ -0,0 +1,236 @@
+/*
+    This file is a part of the wiringBone library
+    Frame extraction for delimited, length prefixed and STX/ETX serial protocols
+*/
+
+#include <string.h>
+#include "FRAME.h"
+
+FrameReader::FrameReader(Stream &stream, size_t capacity)
+    : stream(stream),
+      buffer(capacity),
+      start(0),
+      end(0),
+      scanned(0),
+      pending(0),
+      errorCount(0) {
+    delimited('\n');
+}
+
+void FrameReader::delimited(char delimiter) {
+    mode = frameDelimited;
+    this->delimiter = delimiter;
+    scanned = 0;
+}
+
+void FrameReader::lengthPrefixed(uint8_t headerBytes, bool bigEndian) {
+    mode = frameLengthPrefixed;
+    this->headerBytes = headerBytes < 1 ? 1 : (headerBytes > 4 ? 4 : headerBytes);
+    this->bigEndian = bigEndian;
+    scanned = 0;
+}
+
+void FrameReader::stxEtx(uint8_t stx, uint8_t etx, bool bcc) {
+    mode = frameStxEtx;
+    this->stx = stx;
+    this->etx = etx;
+    this->bcc = bcc;
+    scanned = 0;
+}
+
+unsigned long FrameReader::errors(void) {
+    return errorCount;
+}
+
+bool FrameReader::next(std::string_view &frame) {
+    // The last frame was handed out in place, its bytes can go now
+    if (pending > 0) {
+        stream.consume(pending);
+        pending = 0;
+    }
+
+    if (start == end) {
+        start = end = 0;
+    }
+
+    // Scanned in place in the stream's own buffer while nothing is held here
+    const char *window;
+    size_t length;
+    while (start == end && (length = stream.peekWindow(window)) > 0) {
+        // Frames found in place are held to the same limit as buffered ones
+        size_t limit = length < buffer.size() ? length : buffer.size();
+        size_t offset = 0;
+        if (extract(window, offset, limit, frame)) {
+            // Stays in the stream until the caller is done with the view
+            pending = offset;
+            return true;
+        }
+        size_t partial = limit - offset;
+        if (partial >= buffer.size()) {
+            // No boundary within a buffer's worth, the frame can never fit
+            errorCount++;
+            stream.consume(limit);
+            scanned = 0;
+            continue;
+        }
+        if (limit < length || (size_t)stream.available() <= length) {
+            // The rest follows in the same window or has not arrived yet
+            stream.consume(offset);
+            if (limit < length) {
+                continue;
+            }
+            return false;
+        }
+        // The window stops at the end of the stream's ring, join both parts here
+        memcpy(buffer.data(), window + offset, partial);
+        end = partial;
+        stream.consume(length);
+    }
+
+    if (extract(buffer.data(), start, end, frame)) {
+        return true;
+    }
+
+    // Only a full buffer moves the partial frame to the front, so a frame
+    // arriving in small reads is not copied again on every call
+    if (start == end) {
+        start = end = 0;
+    } else if (end == buffer.size() && start > 0) {
+        memmove(buffer.data(), buffer.data() + start, end - start);
+        end -= start;
+        start = 0;
+    }
+
+    if (end == buffer.size()) {
+        // No boundary in a full buffer, the frame can never fit
+        errorCount++;
+        start = end = scanned = 0;
+    }
+
+    size_t peeked;
+    if (receive(peeked) == 0) {
+        return false;
+    }
+    size_t committed = end - peeked;
+    bool found = extract(buffer.data(), start, end, frame);
+    if (peeked > 0) {
+        // Peeked bytes past the frame stay in the stream and are scanned in place next time
+        size_t used = !found ? end : (start > committed ? start : committed);
+        stream.consume(used - committed);
+        end = used;
+    }
+    return found;
+}
+
+// Takes only what is already waiting so the call never blocks. Bytes copied from the
+// stream's window are left there and counted in peeked, the rest are read out
+size_t FrameReader::receive(size_t &peeked) {
+    size_t count = buffer.size() - end;
+    const char *window;
+    size_t length = stream.peekWindow(window);
+
+    peeked = 0;
+    if (length > 0) {
+        if (length < count) {
+            count = length;
+        }
+        memcpy(buffer.data() + end, window, count);
+        peeked = count;
+    } else {
+        int ready = stream.available();
+        if (ready <= 0) {
+            return 0;
+        }
+        if ((size_t)ready < count) {
+            count = ready;
+        }
+        count = stream.readBytes(buffer.data() + end, count);
+    }
+    end += count;
+    return count;
+}
+
+bool FrameReader::extract(const char *data, size_t &start, size_t end, std::string_view &frame) {
+    while (start < end) {
+        switch (mode) {
+        case frameDelimited: {
+            const char *found = (const char*)memchr(data + start + scanned, delimiter, end - start - scanned);
+            if (!found) {
+                scanned = end - start;
+                return false;
+            }
+            frame = std::string_view(data + start, found - (data + start));
+            start = found - data + 1;
+            scanned = 0;
+            return true;
+        }
+
+        case frameLengthPrefixed: {
+            if (end - start < headerBytes) {
+                return false;
+            }
+            size_t length = 0;
+            for (uint8_t index = 0; index < headerBytes; index++) {
+                uint8_t byte = data[start + (bigEndian ? index : headerBytes - 1 - index)];
+                length = (length << 8) | byte;
+            }
+            if (length > buffer.size() - headerBytes) {
+                // Cannot be buffered, drop the header and resynchronise on what follows
+                errorCount++;
+                start += headerBytes;
+                continue;
+            }
+            if (end - start < headerBytes + length) {
+                return false;
+            }
+            frame = std::string_view(data + start + headerBytes, length);
+            start += headerBytes + length;
+            return true;
+        }
+
+        case frameStxEtx: {
+            // Skip noise before STX
+            const char *open = (const char*)memchr(data + start, stx, end - start);
+            if (!open) {
+                start = end;
+                scanned = 0;
+                return false;
+            }
+            if (open - data != (ptrdiff_t)start) {
+                start = open - data;
+                scanned = 0;
+            }
+
+            size_t from = start + 1 + scanned;
+            const char *close = (const char*)memchr(data + from, etx, end - from);
+            if (!close) {
+                scanned = end - start - 1;
+                return false;
+            }
+            size_t closeIndex = close - data;
+            if (bcc && closeIndex + 1 >= end) {
+                scanned = closeIndex - start - 1;
+                return false;
+            }
+
+            std::string_view payload(data + start + 1, closeIndex - start - 1);
+            start = closeIndex + 1 + (bcc ? 1 : 0);
+            scanned = 0;
+
+            if (bcc) {
+                uint8_t sum = etx;
+                for (char byte : payload) {
+                    sum ^= (uint8_t)byte;
+                }
+                if (sum != (uint8_t)data[closeIndex + 1]) {
+                    errorCount++;
+                    continue;
+                }
+            }
+            frame = payload;
+            return true;
+        }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,58 @@
+/*
+    This file is a part of the wiringBone library
+    Frame extraction for delimited, length prefixed and STX/ETX serial protocols
+*/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string_view>
+#include <vector>
+#include "Stream.h"
+
+#define FRAME_BUFFER_SIZE 1024
+
+#define ASCII_STX 0x02
+#define ASCII_ETX 0x03
+
+typedef enum { frameDelimited, frameLengthPrefixed, frameStxEtx } FrameMode;
+
+class FrameReader {
+public:
+    explicit FrameReader(Stream &stream, size_t capacity = FRAME_BUFFER_SIZE);
+
+    void delimited(char delimiter = '\n');
+    void lengthPrefixed(uint8_t headerBytes = 1, bool bigEndian = true);
+    // With bcc, one byte after ETX holds the XOR of the payload and ETX
+    void stxEtx(uint8_t stx = ASCII_STX, uint8_t etx = ASCII_ETX, bool bcc = true);
+
+    // Payload of the next complete frame without framing bytes. The view points into the
+    // stream's own receive buffer when it exposes one, or into the reader's buffer for a
+    // frame that wrapped around it, and stays valid until the next call
+    bool next(std::string_view &frame);
+
+    unsigned long errors(void);     // Checksum failures and frames too large for the buffer
+
+private:
+    Stream &stream;
+    std::vector<char> buffer;       // Holds only frames that could not be scanned in place
+    size_t start;                   // First unconsumed byte
+    size_t end;                     // One past the last received byte
+    size_t scanned;                 // Bytes after start already searched for a boundary
+    size_t pending;                 // Stream bytes behind the last in-place frame, consumed on the next call
+    unsigned long errorCount;
+
+    FrameMode mode;
+    char delimiter;
+    uint8_t headerBytes;
+    bool bigEndian;
+    uint8_t stx, etx;
+    bool bcc;
+
+    bool extract(const char *data, size_t &start, size_t end, std::string_view &frame);
+    size_t receive(size_t &peeked);
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*
+    This file is a part of the wiringBone library
+    Prioritized transaction scheduler owning one I2C adapter
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+#include "I2CBus.h"
+
+static uint64_t monotonic_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+I2CBus::I2CBus(int busNum)
+    : nextSequence(0),
+      exitFlag(false) {
+    twi_init(&bus, busNum);
+    worker = std::thread(&I2CBus::run, this);
+}
+
+I2CBus::~I2CBus() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        exitFlag = true;
+    }
+    queueCv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+    if (bus.fd >= 0) {
+        close(bus.fd);
+    }
+}
+
+std::future<I2CResult> I2CBus::submit(uint8_t address, const std::vector<uint8_t> &tx, size_t rxLength,
+                                      I2CPriority priority) {
+    std::shared_ptr<std::promise<I2CResult>> result = std::make_shared<std::promise<I2CResult>>();
+    std::future<I2CResult> future = result->get_future();
+    enqueue(Transaction{address, tx, rxLength, priority, 0, 0, result, nullptr});
+    return future;
+}
+
+void I2CBus::submit(uint8_t address, const std::vector<uint8_t> &tx, size_t rxLength,
+                    I2CPriority priority, Completion done) {
+    enqueue(Transaction{address, tx, rxLength, priority, 0, 0, nullptr, done});
+}
+
+I2CResult I2CBus::transfer(uint8_t address, const std::vector<uint8_t> &tx, size_t rxLength,
+                           I2CPriority priority) {
+    if (std::this_thread::get_id() == worker.get_id()) {
+        return execute(Transaction{address, tx, rxLength, priority, 0, monotonic_ns(), nullptr, nullptr});
+    }
+    return submit(address, tx, rxLength, priority).get();
+}
+
+void I2CBus::enqueue(Transaction transaction) {
+    transaction.submitted_ns = monotonic_ns();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        transaction.sequence = nextSequence++;
+        queue.push(std::move(transaction));
+    }
+    queueCv.notify_one();
+}
+
+I2CDeviceStats I2CBus::stats(uint8_t address) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    auto found = deviceStats.find(address);
+    return found != deviceStats.end() ? found->second : I2CDeviceStats{0, 0, 0, 0};
+}
+
+void I2CBus::resetStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    deviceStats.clear();
+}
+
+I2CResult I2CBus::execute(const Transaction &transaction) {
+    I2CResult result{0, std::vector<uint8_t>(transaction.rxLength)};
+    if (transaction.rxLength > 0) {
+        if (twi_writeRead(&bus, transaction.address, transaction.tx.data(), transaction.tx.size(),
+                          result.data.data(), transaction.rxLength) != (ssize_t) transaction.rxLength) {
+            result.status = -1;
+        }
+    } else if (twi_writeTo(&bus, transaction.address, (uint8_t*) transaction.tx.data(), transaction.tx.size(), 1, 1) != 0) {
+        result.status = -1;
+    }
+
+    uint64_t latency = monotonic_ns() - transaction.submitted_ns;
+    {
+        std::lock_guard<std::mutex> statsLock(statsMutex);
+        I2CDeviceStats &device = deviceStats[transaction.address];
+        device.transactions++;
+        device.errors += (result.status != 0);
+        device.totalLatency_ns += latency;
+        if (latency > device.maxLatency_ns) {
+            device.maxLatency_ns = latency;
+        }
+    }
+
+    return result;
+}
+
+// Drains the queue highest priority first, one transaction straight after another
+void I2CBus::run() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueCv.wait(lock, [this] { return exitFlag || !queue.empty(); });
+        if (queue.empty()) {
+            return;
+        }
+
+        Transaction transaction = queue.top();
+        queue.pop();
+        lock.unlock();
+
+        I2CResult result = execute(transaction);
+        if (transaction.done) {
+            transaction.done(result);
+        } else {
+            transaction.result->set_value(std::move(result));
+        }
+        lock.lock();
+    }
+}
+
+I2CBus *i2cBus(int busNum)
+{
+  static std::mutex registryMutex;
+  static std::map<int, std::unique_ptr<I2CBus>> buses;
+
+  std::lock_guard<std::mutex> lock(registryMutex);
+  std::unique_ptr<I2CBus> &bus = buses[busNum];
+  if (!bus)
+    bus.reset(new I2CBus(busNum));
+  return bus.get();
+}
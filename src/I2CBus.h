@@ -0,0 +1,93 @@
+/*
+    This file is a part of the wiringBone library
+    Prioritized transaction scheduler owning one I2C adapter
+*/
+
+#ifndef I2CBUS_H
+#define I2CBUS_H
+
+#include <stdint.h>
+#include <vector>
+#include <queue>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include "twi.h"
+
+typedef enum { i2cBackground = 0, i2cNormal = 1, i2cCritical = 2 } I2CPriority;
+
+struct I2CResult {
+    int status;                 // 0 on success, -1 on failure
+    std::vector<uint8_t> data;  // Bytes read
+};
+
+struct I2CDeviceStats {
+    uint32_t transactions;
+    uint32_t errors;
+    uint64_t totalLatency_ns;   // Submission to completion, includes queueing
+    uint64_t maxLatency_ns;
+};
+
+class I2CBus {
+public:
+    typedef std::function<void(const I2CResult&)> Completion;
+
+    explicit I2CBus(int busNum);
+    ~I2CBus();
+
+    // Writes tx, then reads rxLength bytes after a repeated start; either part may be empty
+    std::future<I2CResult> submit(uint8_t address, const std::vector<uint8_t> &tx, size_t rxLength,
+                                  I2CPriority priority = i2cNormal);
+    void submit(uint8_t address, const std::vector<uint8_t> &tx, size_t rxLength,
+                I2CPriority priority, Completion done);
+
+    // Blocks until the transaction is done. Called from a Completion it runs in place,
+    // since the worker that would drain the queue is the caller
+    I2CResult transfer(uint8_t address, const std::vector<uint8_t> &tx, size_t rxLength,
+                       I2CPriority priority = i2cNormal);
+
+    I2CDeviceStats stats(uint8_t address);
+    void resetStats();
+
+private:
+    struct Transaction {
+        uint8_t address;
+        std::vector<uint8_t> tx;
+        size_t rxLength;
+        I2CPriority priority;
+        uint64_t sequence;      // Keeps FIFO order within a priority
+        uint64_t submitted_ns;
+        std::shared_ptr<std::promise<I2CResult>> result;
+        Completion done;
+    };
+
+    struct Later {
+        bool operator()(const Transaction &a, const Transaction &b) const {
+            return a.priority != b.priority ? a.priority < b.priority : a.sequence > b.sequence;
+        }
+    };
+
+    twi_bus bus;
+    std::priority_queue<Transaction, std::vector<Transaction>, Later> queue;
+    std::map<uint8_t, I2CDeviceStats> deviceStats;
+    uint64_t nextSequence;
+    bool exitFlag;
+
+    std::mutex queueMutex;
+    std::mutex statsMutex;
+    std::condition_variable queueCv;
+    std::thread worker;
+
+    void enqueue(Transaction transaction);
+    I2CResult execute(const Transaction &transaction);
+    void run();
+};
+
+// The scheduler shared by every user of /dev/i2c-busNum, Wire included, created on first use
+I2CBus *i2cBus(int busNum);
+
+#endif
@@ -6,10 +6,10 @@ Implementation of the main logic for the parking system
 #include "Wiring.h"
 #include "parking_system.h"
 #include "MAIN.h"
+#include "TASK.h"
+#include "PINMUX.h"
 #include <signal.h>
 #include <atomic>
-#include <thread>
-#include <chrono>
 #include <iostream>
 #include <exception>
 
@@ -53,12 +53,9 @@ void loop() {
         if (!running) return;       // Exit the loop if the program is stopping
         
         if (firstRun) {
-            parkingSystem.run();    // Only start the monitoring threads once
+            parkingSystem.run();    // Only schedule the monitoring timers once
             firstRun = false;
         }
-        
-        // Sleep to prevent tight looping
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     } catch (const std::exception& e) {
         std::cerr << "Error in loop: " << e.what() << std::endl;
         running = false;  // Stop the program on exception
@@ -68,6 +65,15 @@ void loop() {
     }
 }
 
+// Runs loop() as a task so sketches can start their own tasks on the same event loop
+Task loopTask() {
+    while (running) {
+        loop();
+        co_await delayMs(LOOP_INTERVAL);
+    }
+    eventLoop().stop();
+}
+
 int main() {
     // Register signal handlers
     signal(SIGINT, StopProgram);    // Ctrl+C
@@ -75,12 +81,16 @@ int main() {
 
     std::cout << "\nStarting Bi-Directional Parking Gate System...\n" << std::endl;
 
+    // Mux the pins UserPinConfig.h asks for, touching only those that differ
+    pinmuxPlan()->apply();
+
     // Call user-defined setup function
     setup();
 
     // Main loop
-    while (running) {
-        loop();
+    if (running) {
+        loopTask();
+        eventLoop().run();
     }
 
     // Stop the parking system when exiting
@@ -95,6 +105,7 @@ int main() {
         }
         std::cout << "Program terminated gracefully." << std::endl;
     }
+    pinmuxPlan()->restore();
     
     return 0;
 }
@@ -23,6 +23,8 @@
 
 #include <signal.h>
 
+#define LOOP_INTERVAL 100   // ms between loop() calls, other tasks run in between
+
 // Function declarations
 void StopProgram(int signal);
 void setup();
@@ -0,0 +1,155 @@
+/*
+    This file is a part of the wiringBone library
+    Servo motion profiles streamed to PWM / PRU outputs
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "MOTION.h"
+#include "PWM.h"
+
+// Normalized position (0..1) at normalized time t (0..1)
+static float profilePosition(float t, MotionShape shape, float accel)
+{
+  if(shape == scurve)
+  {
+    // Quintic smoothstep: zero velocity and acceleration at both ends
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+  }
+
+  // Trapezoidal velocity: ramp up for 'accel', cruise, ramp down for 'accel'
+  float vmax = 1.0f / (1.0f - accel);
+  if(t < accel)
+  return vmax * t * t / (2.0f * accel);
+  if(t <= 1.0f - accel)
+  return vmax * (t - accel / 2.0f);
+  return 1.0f - vmax * (1.0f - t) * (1.0f - t) / (2.0f * accel);
+}
+
+std::vector<uint32_t> motionProfile(uint32_t from_ns, uint32_t to_ns, uint32_t duration_ms,
+                                    MotionShape shape, float accelFraction)
+{
+  uint32_t count = (duration_ms * 1000 + SERVO_FRAME_PERIOD_US - 1) / SERVO_FRAME_PERIOD_US;
+  if(count == 0)
+  count = 1;
+
+  if(accelFraction <= 0.0f || accelFraction > 0.5f)
+  accelFraction = 0.5f;
+
+  std::vector<uint32_t> frames(count);
+  float span = (float)to_ns - (float)from_ns;
+  for(uint32_t index = 1; index < count; index++)
+  {
+    float position = profilePosition((float)index / count, shape, accelFraction);
+    frames[index - 1] = (uint32_t)lroundf((float)from_ns + span * position);
+  }
+  frames[count - 1] = to_ns;
+  return frames;
+}
+
+ServoMotion::ServoMotion(Pin pin, uint32_t initial_ns)
+    : ServoMotion([pin](uint32_t ns) { setPulseWidthns(pin, ns); }, initial_ns) {
+}
+
+ServoMotion::ServoMotion(DutyWriter writer, uint32_t initial_ns)
+    : writer(writer),
+      current_ns(initial_ns),
+      nextFrame(0),
+      generation(0),
+      complete(true),
+      exitFlag(false) {
+    worker = std::thread(&ServoMotion::run, this);
+}
+
+ServoMotion::~ServoMotion() {
+    {
+        std::lock_guard<std::mutex> lock(motionMutex);
+        exitFlag = true;
+    }
+    motionCv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void ServoMotion::moveTo(uint32_t target_ns, uint32_t duration_ms, MotionShape shape, Completion done) {
+    {
+        std::lock_guard<std::mutex> lock(motionMutex);
+        frames = motionProfile(current_ns, target_ns, duration_ms, shape);
+        nextFrame = 0;
+        generation++;
+        onComplete = done;
+        complete = false;
+    }
+    motionCv.notify_all();
+}
+
+void ServoMotion::stop() {
+    {
+        std::lock_guard<std::mutex> lock(motionMutex);
+        frames.clear();
+        nextFrame = 0;
+        generation++;
+        onComplete = nullptr;
+        complete = true;
+    }
+    motionCv.notify_all();
+    doneCv.notify_all();
+}
+
+bool ServoMotion::isComplete() {
+    std::lock_guard<std::mutex> lock(motionMutex);
+    return complete;
+}
+
+bool ServoMotion::waitComplete(uint32_t timeout_ms) {
+    std::unique_lock<std::mutex> lock(motionMutex);
+    if (timeout_ms == 0) {
+        doneCv.wait(lock, [this] { return complete; });
+        return true;
+    }
+    return doneCv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] { return complete; });
+}
+
+uint32_t ServoMotion::position() {
+    std::lock_guard<std::mutex> lock(motionMutex);
+    return current_ns;
+}
+
+// Streams one frame per servo period on absolute deadlines so write latency does not accumulate
+void ServoMotion::run() {
+    std::unique_lock<std::mutex> lock(motionMutex);
+    while (!exitFlag) {
+        if (nextFrame >= frames.size()) {
+            motionCv.wait(lock);
+            continue;
+        }
+
+        uint32_t active = generation;
+        auto deadline = std::chrono::steady_clock::now();
+        while (!exitFlag && active == generation && nextFrame < frames.size()) {
+            uint32_t value = frames[nextFrame++];
+            current_ns = value;
+            lock.unlock();
+            writer(value);
+            lock.lock();
+
+            deadline += std::chrono::microseconds(SERVO_FRAME_PERIOD_US);
+            motionCv.wait_until(lock, deadline, [&] { return exitFlag || active != generation; });
+        }
+
+        // The last frame has been held for a full servo period, report completion
+        if (active == generation && !complete) {
+            complete = true;
+            Completion done = onComplete;
+            onComplete = nullptr;
+            lock.unlock();
+            doneCv.notify_all();
+            if (done) {
+                done();
+            }
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*
+    This file is a part of the wiringBone library
+    Servo motion profiles streamed to PWM / PRU outputs
+*/
+
+#ifndef MOTION_H
+#define MOTION_H
+
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "PINS.h"
+
+#define SERVO_FRAME_PERIOD_US 20000     // 50 Hz servo frame
+#define DEFAULT_ACCEL_FRACTION 0.25f    // Share of the move spent accelerating (and decelerating)
+
+typedef enum { trapezoidal = 0, scurve = 1 } MotionShape;
+
+// Pulse widths in ns, one per servo frame, ending exactly on to_ns
+std::vector<uint32_t> motionProfile(uint32_t from_ns, uint32_t to_ns, uint32_t duration_ms,
+                                    MotionShape shape, float accelFraction = DEFAULT_ACCEL_FRACTION);
+
+class ServoMotion {
+public:
+    typedef std::function<void(uint32_t)> DutyWriter;   // Receives pulse width in ns
+    typedef std::function<void()> Completion;
+
+    ServoMotion(Pin pin, uint32_t initial_ns);
+    ServoMotion(DutyWriter writer, uint32_t initial_ns);
+    ~ServoMotion();
+
+    // Starts a profile from the current position, replacing any profile in progress
+    void moveTo(uint32_t target_ns, uint32_t duration_ms, MotionShape shape = scurve, Completion done = nullptr);
+    void stop();                                // Abort the profile and hold the current position
+    bool isComplete();
+    bool waitComplete(uint32_t timeout_ms = 0); // 0 waits forever, false on timeout
+    uint32_t position();
+
+private:
+    DutyWriter writer;
+    uint32_t current_ns;
+    std::vector<uint32_t> frames;
+    size_t nextFrame;
+    uint32_t generation;
+    Completion onComplete;
+    bool complete;
+    bool exitFlag;
+
+    std::mutex motionMutex;
+    std::condition_variable motionCv;
+    std::condition_variable doneCv;
+    std::thread worker;
+
+    void run();
+};
+
+#endif
@@ -44,13 +44,6 @@ class OVERLAY
     // Internal utility methods
     void configureDefaultPins();
     void restoreAllPins();
-    bool isValidMode(Pin pin);
-    void loadVirtualCape(Pin pin);
-    std::string getFilePathForPin(Pin pin);
-    std::string getModeString(Pin pin);
-
-    // Loads a virtual cape
-    int loadCape(std::string capeName);
 };
 
 // Method for setting pin mode
@@ -0,0 +1,278 @@
+/*
+    This file is a part of the wiringBone library
+    Pinmux plan: the wanted mode of every header pin, applied as a diff
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <wordexp.h>
+#include <iostream>
+#include <fstream>
+#include "PINMUX.h"
+#include "CLOCK.h"
+#include "UserPinConfig.h"
+
+#define PLAN(header, number, cape) {#header, number, cape, header##_MODE, "", "", ""}
+
+PinmuxPlan::PinmuxPlan()
+    : pins{
+        PLAN(P8_3, 38, emmc),   PLAN(P8_4, 39, emmc),   PLAN(P8_5, 34, emmc),   PLAN(P8_6, 35, emmc),
+        PLAN(P8_7, 66, none),   PLAN(P8_8, 67, none),   PLAN(P8_9, 69, none),   PLAN(P8_10, 68, none),
+        PLAN(P8_11, 45, none),  PLAN(P8_12, 44, none),  PLAN(P8_13, 23, none),  PLAN(P8_14, 26, none),
+        PLAN(P8_15, 47, none),  PLAN(P8_16, 46, none),  PLAN(P8_17, 27, none),  PLAN(P8_18, 65, none),
+        PLAN(P8_19, 22, none),  PLAN(P8_20, 63, emmc),  PLAN(P8_21, 62, emmc),  PLAN(P8_22, 37, emmc),
+        PLAN(P8_23, 36, emmc),  PLAN(P8_24, 33, emmc),  PLAN(P8_25, 32, emmc),  PLAN(P8_26, 61, none),
+        PLAN(P8_27, 86, hdmi),  PLAN(P8_28, 88, hdmi),  PLAN(P8_29, 87, hdmi),  PLAN(P8_30, 89, hdmi),
+        PLAN(P8_31, 10, hdmi),  PLAN(P8_32, 11, hdmi),  PLAN(P8_33, 9, hdmi),   PLAN(P8_34, 81, hdmi),
+        PLAN(P8_35, 8, hdmi),   PLAN(P8_36, 80, hdmi),  PLAN(P8_37, 78, hdmi),  PLAN(P8_38, 79, hdmi),
+        PLAN(P8_39, 76, hdmi),  PLAN(P8_40, 77, hdmi),  PLAN(P8_41, 74, hdmi),  PLAN(P8_42, 75, hdmi),
+        PLAN(P8_43, 72, hdmi),  PLAN(P8_44, 73, hdmi),  PLAN(P8_45, 70, hdmi),  PLAN(P8_46, 71, hdmi),
+        PLAN(P9_11, 30, none),  PLAN(P9_12, 60, none),  PLAN(P9_13, 31, none),  PLAN(P9_14, 50, none),
+        PLAN(P9_15, 48, none),  PLAN(P9_16, 51, none),  PLAN(P9_17, 5, none),   PLAN(P9_18, 4, none),
+        PLAN(P9_21, 3, none),   PLAN(P9_22, 2, none),   PLAN(P9_23, 49, none),  PLAN(P9_24, 15, none),
+        PLAN(P9_25, 117, audio), PLAN(P9_26, 14, none), PLAN(P9_27, 115, none), PLAN(P9_28, 113, audio),
+        PLAN(P9_29, 111, audio), PLAN(P9_30, 112, none), PLAN(P9_31, 110, audio), PLAN(P9_41, 20, none),
+        PLAN(P9_42, 7, none)
+      } {
+}
+
+PinmuxPlan::Entry *PinmuxPlan::find(const std::string &name) {
+    for (Entry &entry : pins) {
+        if (name == entry.name) {
+            return &entry;
+        }
+    }
+    return NULL;
+}
+
+// Older kernels number the helper directories, so the path is globbed once and kept
+static std::string resolveStatePath(const char *name)
+{
+    char pattern[100];
+    wordexp_t path;
+    std::string resolved;
+
+    snprintf(pattern, sizeof(pattern), OCPDIR, name);
+    if (wordexp(pattern, &path, WRDE_NOCMD) != 0) {
+        return pattern;
+    }
+    resolved = path.we_wordc ? path.we_wordv[0] : pattern;
+    wordfree(&path);
+    return resolved;
+}
+
+bool PinmuxPlan::readState(Entry &entry) {
+    char state[PINMUX_STATE_LENGTH];
+    ssize_t length;
+    int fd;
+
+    if (entry.path.empty()) {
+        entry.path = resolveStatePath(entry.name);
+    }
+    if ((fd = open(entry.path.c_str(), O_RDONLY | O_CLOEXEC)) < 0) {
+        // The helper may only appear once its cape is loaded
+        entry.path.clear();
+        entry.current.clear();
+        return false;
+    }
+    length = read(fd, state, sizeof(state) - 1);
+    close(fd);
+    if (length < 0) {
+        entry.current.clear();
+        return false;
+    }
+    while (length > 0 && (state[length - 1] == '\n' || state[length - 1] == ' ')) {
+        length--;
+    }
+    entry.current.assign(state, length);
+    return true;
+}
+
+int PinmuxPlan::writeState(Entry &entry, const std::string &state) {
+    int fd;
+
+    if (entry.path.empty()) {
+        entry.path = resolveStatePath(entry.name);
+    }
+    if ((fd = open(entry.path.c_str(), O_WRONLY | O_CLOEXEC)) < 0) {
+        perror((std::string(entry.name) + ": Config overlay failed").c_str());
+        return -1;
+    }
+    if (write(fd, state.data(), state.size()) < 0) {
+        perror((std::string(entry.name) + ": Config overlay mode write failed").c_str());
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    if (entry.original.empty()) {
+        entry.original = entry.current.empty() ? "default" : entry.current;
+    }
+    entry.current = state;
+    return 0;
+}
+
+int PinmuxPlan::apply(void) {
+    std::lock_guard<std::mutex> lock(planMutex);
+    std::vector<Entry*> changes;
+    std::vector<VirtualCapes> capes;
+    uint64_t start = nanos();
+    int planned = 0, written = 0, result = 0;
+
+    // One read pass over the pins in use, so the writes below are only the real differences
+    for (Entry &entry : pins) {
+        if (entry.mode == disabled) {
+            continue;
+        }
+        planned++;
+        readState(entry);
+        if (entry.current != pinmuxState(entry.pinNum, entry.mode)) {
+            changes.push_back(&entry);
+            if (entry.cape != none) {
+                capes.push_back(entry.cape);
+            }
+        }
+    }
+
+    if (!capes.empty() && loadCapes(capes) < 0) {
+        result = -1;
+    }
+    for (Entry *entry : changes) {
+        if (writeState(*entry, pinmuxState(entry->pinNum, entry->mode)) < 0) {
+            result = -1;
+        } else {
+            written++;
+        }
+    }
+
+    std::cout << "Pinmux plan applied: " << written << " of " << planned
+              << " pins changed in " << (nanos() - start) / 1000 << " us" << std::endl;
+    return result;
+}
+
+int PinmuxPlan::require(const Pin &pin) {
+    std::lock_guard<std::mutex> lock(planMutex);
+    Entry *entry = find(pin.pinName);
+    bool valid = false;
+
+    for (int index = 0; index < pin.numValidModes; ++index) {
+        valid = valid || pin.validModes[index] == pin.selectedMode;
+    }
+    if (!entry || !valid) {
+        std::cerr << pin.pinName << ": Invalid mode selected" << std::endl;
+        return -1;
+    }
+    entry->mode = pin.selectedMode;
+
+    // Pins the startup pass already read or wrote cost no sysfs access
+    std::string state = pinmuxState(entry->pinNum, entry->mode);
+    if (entry->current.empty()) {
+        readState(*entry);
+    }
+    if (entry->current == state) {
+        return 0;
+    }
+    if (entry->cape != none && loadCapes({entry->cape}) < 0) {
+        return -1;
+    }
+    return writeState(*entry, state);
+}
+
+PinModes PinmuxPlan::planned(const Pin &pin) {
+    std::lock_guard<std::mutex> lock(planMutex);
+    Entry *entry = find(pin.pinName);
+    return entry ? entry->mode : disabled;
+}
+
+int PinmuxPlan::release(const Pin &pin) {
+    std::lock_guard<std::mutex> lock(planMutex);
+    Entry *entry = find(pin.pinName);
+
+    if (!entry) {
+        std::cerr << pin.pinName << ": No pinmux helper" << std::endl;
+        return -1;
+    }
+    entry->mode = disabled;
+    if (entry->current == "default") {
+        return 0;
+    }
+    if (writeState(*entry, "default") < 0) {
+        return -1;
+    }
+    entry->original.clear();
+    return 0;
+}
+
+void PinmuxPlan::restore(void) {
+    std::lock_guard<std::mutex> lock(planMutex);
+    for (Entry &entry : pins) {
+        if (entry.original.empty()) {
+            continue;
+        }
+        writeState(entry, entry.original);
+        entry.original.clear();
+    }
+}
+
+PinmuxPlan *pinmuxPlan()
+{
+  static PinmuxPlan plan;
+  return &plan;
+}
+
+std::string pinmuxState(int pinNum, PinModes mode)
+{
+  switch (mode) {
+    case gpio: return "gpio_pd";
+    case pwm: return (pinNum == 113) ? "pwm2" : "pwm";
+    case pruin: return "pruin";
+    case pruout: return "pruout";
+    case i2c: return "i2c";
+    case uart: return "uart";
+    case spi: return (pinNum == 7) ? "spics" : "spi";
+    default: return "";
+  }
+}
+
+int loadCapes(const std::vector<VirtualCapes> &capes)
+{
+  static const char *names[] = {NULL, "cape-univ-hdmi", "cape-univ-audio", "cape-univ-emmc"};
+  std::string loaded, line;
+  wordexp_t path;
+  bool wrote = false;
+  int result = 0;
+
+  if (wordexp(SLOTS, &path, WRDE_NOCMD) != 0) {
+    std::cerr << "Cape load failed: no slots file" << std::endl;
+    return -1;
+  }
+  std::string slots = path.we_wordc ? path.we_wordv[0] : SLOTS;
+  wordfree(&path);
+
+  std::ifstream current(slots);
+  while (std::getline(current, line))
+    loaded += line + "\n";
+  current.close();
+
+  for (VirtualCapes cape : capes) {
+    if (cape == none || loaded.find(names[cape]) != std::string::npos)
+      continue;
+    FILE *fd = fopen(slots.c_str(), "w");
+    if (!fd || fprintf(fd, "%s", names[cape]) < 0) {
+      perror("Cape load failed");
+      result = -1;
+    } else {
+      wrote = true;
+    }
+    if (fd)
+      fclose(fd);
+    loaded += names[cape];
+    loaded += "\n";
+  }
+
+  // The helpers for every new cape appear within the same settle time
+  if (wrote)
+    usleep(1000 * 1000);
+  return result;
+}
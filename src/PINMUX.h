@@ -0,0 +1,73 @@
+/*
+    This file is a part of the wiringBone library
+    Pinmux plan: the wanted mode of every header pin, applied as a diff
+*/
+
+#ifndef PINMUX_H
+#define PINMUX_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <linux/version.h>
+#include "PINS.h"
+
+#if LINUX_VERSION_CODE > KERNEL_VERSION(3,8,13)
+#define OCPDIR "/sys/devices/platform/ocp/ocp:%s_pinmux/state"
+#define SLOTS "/sys/devices/platform/bone_capemgr/slots"
+#else
+#define OCPDIR "/sys/devices/ocp.*/%s_pinmux.*/state"
+#define SLOTS "/sys/devices/bone_capemgr.*/slots"
+#endif
+
+#define PINMUX_STATE_LENGTH 16          // Longest state name plus newline
+
+// The plan starts from UserPinConfig.h and grows with pinMode() requests.
+// Pins left disabled are never touched
+class PinmuxPlan {
+public:
+    PinmuxPlan();
+
+    // Reads the state of every planned pin once, then writes only the pins that differ
+    int apply(void);
+
+    // Adds pin.selectedMode to the plan, writing it only if the pin is not already there
+    int require(const Pin &pin);
+
+    // The mode the plan wants for the pin, disabled if it leaves the pin alone
+    PinModes planned(const Pin &pin);
+
+    // Drops the pin from the plan and puts it back in its default state
+    int release(const Pin &pin);
+
+    // Puts pins the plan changed back to the state they had before
+    void restore(void);
+
+private:
+    struct Entry {
+        const char *name;
+        int pinNum;
+        VirtualCapes cape;
+        PinModes mode;                  // Wanted mode, disabled leaves the pin alone
+        std::string path;               // Resolved state file, empty until first used
+        std::string current;            // Last state read or written
+        std::string original;           // State before the plan first wrote it
+    };
+
+    std::vector<Entry> pins;
+    std::mutex planMutex;
+
+    Entry *find(const std::string &name);
+    bool readState(Entry &entry);
+    int writeState(Entry &entry, const std::string &state);
+};
+
+PinmuxPlan *pinmuxPlan();
+
+// The pinmux state name that selects mode on the pin with GPIO number pinNum
+std::string pinmuxState(int pinNum, PinModes mode);
+
+// Loads the universal cape variants not already in the slots, waiting once for all of them
+int loadCapes(const std::vector<VirtualCapes> &capes);
+
+#endif
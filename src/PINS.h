@@ -10,7 +10,7 @@
 #include <mutex> // For mutex
 #include <vector>
 
-enum PinModes { gpio, pruin, pwm, uart, spi, i2c, pruout };
+enum PinModes { gpio, pruin, pwm, uart, spi, i2c, pruout, disabled };
 enum VirtualCapes {none, hdmi, audio, emmc };
 
 // Struct for GPIO pin representation
@@ -41,6 +41,7 @@ extern PinModes P8_11_modes[];
 extern PinModes P8_14_modes[];
 extern PinModes P8_12_modes[];
 extern PinModes P9_12_modes[];
+extern PinModes P9_14_modes[];
 extern PinModes P9_15_modes[];
 extern PinModes P9_23_modes[];
 extern PinModes P9_25_modes[];
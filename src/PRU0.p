@@ -92,7 +92,7 @@ procees_output_end:
 .endm
 
 .macro PROCESS_INPUT
-.mparam PIN, TON_OFFSET, TOFF_OFFSET, PREV_TOGGLE, LAST_STATE, CURRENT_STATE
+.mparam PIN, TON_OFFSET, TOFF_OFFSET, PREV_TOGGLE, LAST_STATE, CURRENT_STATE, AVG_OFFSET
 
   // Process high if pin is high, else process low
   QBBS in_high, CURRENT_STATE
@@ -121,6 +121,33 @@ procees_output_end:
     // Set previous toggle == current time
     MOV PREV_TOGGLE, CURRENT_TIME
 
+    // A full period has completed, skip averaging if window is zero
+    MOV TEMP, AVG_OFFSET
+    LBCO AVG_WINDOW, RAM, TEMP, 24
+    QBEQ process_input_end, AVG_WINDOW, 0
+
+    // Add Ton and period to the 64 bit sums
+    LBCO T_ON, RAM, TON_OFFSET, 4
+    ADD AVG_ON_LO, AVG_ON_LO, T_ON
+    ADC AVG_ON_HI, AVG_ON_HI, 0
+    ADD T_ON, T_ON, T_OFF
+    ADD AVG_PER_LO, AVG_PER_LO, T_ON
+    ADC AVG_PER_HI, AVG_PER_HI, 0
+    ADD AVG_COUNT, AVG_COUNT, 1
+
+    // Keep accumulating while count < window
+    ADD TEMP, TEMP, 4
+    QBLT average_store, AVG_WINDOW, AVG_COUNT
+
+    // Publish the sums in a single write and restart the window
+    ADD TEMP, TEMP, 20
+    SBCO AVG_COUNT, RAM, TEMP, 20
+    SUB TEMP, TEMP, 20
+    ZERO &AVG_COUNT, 20
+
+  average_store:
+    SBCO AVG_COUNT, RAM, TEMP, 20
+
     JMP process_input_end
 
 process_timeout:
@@ -134,6 +161,14 @@ process_timeout:
   SBCO TEMP, RAM, TON_OFFSET, 4
   SBCO TEMP, RAM, TOFF_OFFSET, 4
 
+  // Drop the partial and published averages
+  MOV TEMP, AVG_OFFSET
+  ADD TEMP, TEMP, 4
+  ZERO &AVG_COUNT, 20
+  SBCO AVG_COUNT, RAM, TEMP, 20
+  ADD TEMP, TEMP, 20
+  SBCO AVG_COUNT, RAM, TEMP, 20
+
   // Set previous toggle == current time
   // Though toggle not occured, still to avoid any garbage reading when pulse is restored
   MOV PREV_TOGGLE, CURRENT_TIME
@@ -214,7 +249,7 @@ PROCESS_MAIN:
 
 SKIP_P9_31_OUT:
     // Process input
-    PROCESS_INPUT P9_31_IN, P9_31_TON, P9_31_TOFF, P9_31_PREV_TOGGLE, P9_31_LAST_STATE, P9_31_CURRENT_STATE
+    PROCESS_INPUT P9_31_IN, P9_31_TON, P9_31_TOFF, P9_31_PREV_TOGGLE, P9_31_LAST_STATE, P9_31_CURRENT_STATE, P9_31_AVG
 
 SKIP_P9_31:
 
@@ -232,7 +267,7 @@ SKIP_P9_31:
 
 SKIP_P9_29_OUT:
     // Process input
-    PROCESS_INPUT P9_29_IN, P9_29_TON, P9_29_TOFF, P9_29_PREV_TOGGLE, P9_29_LAST_STATE, P9_29_CURRENT_STATE
+    PROCESS_INPUT P9_29_IN, P9_29_TON, P9_29_TOFF, P9_29_PREV_TOGGLE, P9_29_LAST_STATE, P9_29_CURRENT_STATE, P9_29_AVG
 
 SKIP_P9_29:
 
@@ -250,7 +285,7 @@ SKIP_P9_29:
 
 SKIP_P9_30_OUT:
     // Process input
-    PROCESS_INPUT P9_30_IN, P9_30_TON, P9_30_TOFF, P9_30_PREV_TOGGLE, P9_30_LAST_STATE, P9_30_CURRENT_STATE
+    PROCESS_INPUT P9_30_IN, P9_30_TON, P9_30_TOFF, P9_30_PREV_TOGGLE, P9_30_LAST_STATE, P9_30_CURRENT_STATE, P9_30_AVG
 
 SKIP_P9_30:
 
@@ -268,7 +303,7 @@ SKIP_P9_30:
 
 SKIP_P9_28_OUT:
     // Process input
-    PROCESS_INPUT P9_28_IN, P9_28_TON, P9_28_TOFF, P9_28_PREV_TOGGLE, P9_28_LAST_STATE, P9_28_CURRENT_STATE
+    PROCESS_INPUT P9_28_IN, P9_28_TON, P9_28_TOFF, P9_28_PREV_TOGGLE, P9_28_LAST_STATE, P9_28_CURRENT_STATE, P9_28_AVG
 
 SKIP_P9_28:
 
@@ -286,7 +321,7 @@ SKIP_P9_28:
 
 SKIP_P9_42_OUT:
     // Process input
-    PROCESS_INPUT P9_42_IN, P9_42_TON, P9_42_TOFF, P9_42_PREV_TOGGLE, P9_42_LAST_STATE, P9_42_CURRENT_STATE
+    PROCESS_INPUT P9_42_IN, P9_42_TON, P9_42_TOFF, P9_42_PREV_TOGGLE, P9_42_LAST_STATE, P9_42_CURRENT_STATE, P9_42_AVG
 
 SKIP_P9_42:
 
@@ -304,7 +339,7 @@ SKIP_P9_42:
 
 SKIP_P9_27_OUT:
     // Process input
-    PROCESS_INPUT P9_27_IN, P9_27_TON, P9_27_TOFF, P9_27_PREV_TOGGLE, P9_27_LAST_STATE, P9_27_CURRENT_STATE
+    PROCESS_INPUT P9_27_IN, P9_27_TON, P9_27_TOFF, P9_27_PREV_TOGGLE, P9_27_LAST_STATE, P9_27_CURRENT_STATE, P9_27_AVG
 
 SKIP_P9_27:
 
@@ -322,7 +357,7 @@ SKIP_P9_27:
 
 SKIP_P9_41_OUT:
     // Process input
-    PROCESS_INPUT P9_41_IN, P9_41_TON, P9_41_TOFF, P9_41_PREV_TOGGLE, P9_41_LAST_STATE, P9_41_CURRENT_STATE
+    PROCESS_INPUT P9_41_IN, P9_41_TON, P9_41_TOFF, P9_41_PREV_TOGGLE, P9_41_LAST_STATE, P9_41_CURRENT_STATE, P9_41_AVG
 
 SKIP_P9_41:
 
@@ -340,7 +375,7 @@ SKIP_P9_41:
 
 SKIP_P9_25_OUT:
     // Process input
-    PROCESS_INPUT P9_25_IN, P9_25_TON, P9_25_TOFF, P9_25_PREV_TOGGLE, P9_25_LAST_STATE, P9_25_CURRENT_STATE
+    PROCESS_INPUT P9_25_IN, P9_25_TON, P9_25_TOFF, P9_25_PREV_TOGGLE, P9_25_LAST_STATE, P9_25_CURRENT_STATE, P9_25_AVG
 
 SKIP_P9_25:
 
@@ -379,7 +414,7 @@ SKIP_P8_11:
   QBBC SKIP_P8_16, P8_16_MODE
 
     // Process input
-    PROCESS_INPUT P8_16_IN, P8_16_TON, P8_16_TOFF, P8_16_PREV_TOGGLE, P8_16_LAST_STATE, P8_16_CURRENT_STATE
+    PROCESS_INPUT P8_16_IN, P8_16_TON, P8_16_TOFF, P8_16_PREV_TOGGLE, P8_16_LAST_STATE, P8_16_CURRENT_STATE, P8_16_AVG
 
 SKIP_P8_16:
 
@@ -392,7 +427,7 @@ SKIP_P8_16:
   QBBC SKIP_P8_15, P8_15_MODE
 
     // Process input
-    PROCESS_INPUT P8_15_IN, P8_15_TON, P8_15_TOFF, P8_15_PREV_TOGGLE, P8_15_LAST_STATE, P8_15_CURRENT_STATE
+    PROCESS_INPUT P8_15_IN, P8_15_TON, P8_15_TOFF, P8_15_PREV_TOGGLE, P8_15_LAST_STATE, P8_15_CURRENT_STATE, P8_15_AVG
 
 SKIP_P8_15:
 
@@ -405,7 +440,7 @@ SKIP_P8_15:
   QBBC SKIP_P9_24, P9_24_MODE
 
     // Process input
-    PROCESS_INPUT P9_24_IN, P9_24_TON, P9_24_TOFF, P9_24_PREV_TOGGLE, P9_24_LAST_STATE, P9_24_CURRENT_STATE
+    PROCESS_INPUT P9_24_IN, P9_24_TON, P9_24_TOFF, P9_24_PREV_TOGGLE, P9_24_LAST_STATE, P9_24_CURRENT_STATE, P9_24_AVG
 
 SKIP_P9_24:
 
@@ -26,7 +26,7 @@ const unsigned int PRU0code[] =  {
      0x910c3a82,
      0x91e83885,
      0x10ffffe7,
-     0xc900e023,
+     0xc900e03a,
      0xd100e110,
      0x04e2e9e8,
      0xc91fe80d,
@@ -42,26 +42,49 @@ const unsigned int PRU0code[] =  {
      0x00e4e9e9,
      0xc900fe02,
      0x1d00fefe,
-     0x21003800,
+     0x21004f00,
      0xd100e706,
-     0xc900e60a,
+     0xc900e61b,
      0x04e9e2e3,
      0x81083883,
      0x10e2e2e9,
-     0x21003800,
-     0xd100e605,
+     0x21004f00,
+     0xd100e616,
      0x04e9e2e4,
      0x810c3884,
      0x10e2e2e9,
-     0x21003800,
+     0x240100e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91083883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x21004f00,
      0x04e9e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81083888,
      0x810c3888,
+     0x240100e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2e9,
-     0xc901e023,
+     0xc901e03a,
      0xd101e110,
      0x04e2eae8,
      0xc91fe80d,
@@ -73,30 +96,53 @@ const unsigned int PRU0code[] =  {
      0x00e3eaea,
      0xd101fe06,
      0x1f01fefe,
-     0x21004800,
+     0x21005f00,
      0x00e4eaea,
      0xc901fe02,
      0x1d01fefe,
-     0x21005b00,
+     0x21008900,
      0xd101e706,
-     0xc901e60a,
+     0xc901e61b,
      0x04eae2e3,
      0x81103883,
      0x10e2e2ea,
-     0x21005b00,
-     0xd101e605,
+     0x21008900,
+     0xd101e616,
      0x04eae2e4,
      0x81143884,
      0x10e2e2ea,
-     0x21005b00,
+     0x240130e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91103883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x21008900,
      0x04eae2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81103888,
      0x81143888,
+     0x240130e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2ea,
-     0xc902e023,
+     0xc902e03a,
      0xd102e110,
      0x04e2ebe8,
      0xc91fe80d,
@@ -108,30 +154,53 @@ const unsigned int PRU0code[] =  {
      0x00e3ebeb,
      0xd102fe06,
      0x1f02fefe,
-     0x21006b00,
+     0x21009900,
      0x00e4ebeb,
      0xc902fe02,
      0x1d02fefe,
-     0x21007e00,
+     0x2100c300,
      0xd102e706,
-     0xc902e60a,
+     0xc902e61b,
      0x04ebe2e3,
      0x81183883,
      0x10e2e2eb,
-     0x21007e00,
-     0xd102e605,
+     0x2100c300,
+     0xd102e616,
      0x04ebe2e4,
      0x811c3884,
      0x10e2e2eb,
-     0x21007e00,
+     0x240160e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91183883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x2100c300,
      0x04ebe2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81183888,
      0x811c3888,
+     0x240160e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2eb,
-     0xc903e023,
+     0xc903e03a,
      0xd103e110,
      0x04e2ece8,
      0xc91fe80d,
@@ -143,30 +212,53 @@ const unsigned int PRU0code[] =  {
      0x00e3ecec,
      0xd103fe06,
      0x1f03fefe,
-     0x21008e00,
+     0x2100d300,
      0x00e4ecec,
      0xc903fe02,
      0x1d03fefe,
-     0x2100a100,
+     0x2100fd00,
      0xd103e706,
-     0xc903e60a,
+     0xc903e61b,
      0x04ece2e3,
      0x81203883,
      0x10e2e2ec,
-     0x2100a100,
-     0xd103e605,
+     0x2100fd00,
+     0xd103e616,
      0x04ece2e4,
      0x81243884,
      0x10e2e2ec,
-     0x2100a100,
+     0x240190e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91203883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x2100fd00,
      0x04ece2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81203888,
      0x81243888,
+     0x240190e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2ec,
-     0xc904e023,
+     0xc904e03a,
      0xd104e110,
      0x04e2ede8,
      0xc91fe80d,
@@ -178,30 +270,53 @@ const unsigned int PRU0code[] =  {
      0x00e3eded,
      0xd104fe06,
      0x1f04fefe,
-     0x2100b100,
+     0x21010d00,
      0x00e4eded,
      0xc904fe02,
      0x1d04fefe,
-     0x2100c400,
+     0x21013700,
      0xd104e706,
-     0xc904e60a,
+     0xc904e61b,
      0x04ede2e3,
      0x81283883,
      0x10e2e2ed,
-     0x2100c400,
-     0xd104e605,
+     0x21013700,
+     0xd104e616,
      0x04ede2e4,
      0x812c3884,
      0x10e2e2ed,
-     0x2100c400,
+     0x2401c0e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91283883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x21013700,
      0x04ede2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81283888,
      0x812c3888,
+     0x2401c0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2ed,
-     0xc905e023,
+     0xc905e03a,
      0xd105e110,
      0x04e2eee8,
      0xc91fe80d,
@@ -213,30 +328,53 @@ const unsigned int PRU0code[] =  {
      0x00e3eeee,
      0xd105fe06,
      0x1f05fefe,
-     0x2100d400,
+     0x21014700,
      0x00e4eeee,
      0xc905fe02,
      0x1d05fefe,
-     0x2100e700,
+     0x21017100,
      0xd105e706,
-     0xc905e60a,
+     0xc905e61b,
      0x04eee2e3,
      0x81303883,
      0x10e2e2ee,
-     0x2100e700,
-     0xd105e605,
+     0x21017100,
+     0xd105e616,
      0x04eee2e4,
      0x81343884,
      0x10e2e2ee,
-     0x2100e700,
+     0x2401f0e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91303883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x21017100,
      0x04eee2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81303888,
      0x81343888,
+     0x2401f0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2ee,
-     0xc906e023,
+     0xc906e03a,
      0xd106e110,
      0x04e2efe8,
      0xc91fe80d,
@@ -248,30 +386,53 @@ const unsigned int PRU0code[] =  {
      0x00e3efef,
      0xd106fe06,
      0x1f06fefe,
-     0x2100f700,
+     0x21018100,
      0x00e4efef,
      0xc906fe02,
      0x1d06fefe,
-     0x21010a00,
+     0x2101ab00,
      0xd106e706,
-     0xc906e60a,
+     0xc906e61b,
      0x04efe2e3,
      0x81383883,
      0x10e2e2ef,
-     0x21010a00,
-     0xd106e605,
+     0x2101ab00,
+     0xd106e616,
      0x04efe2e4,
      0x813c3884,
      0x10e2e2ef,
-     0x21010a00,
+     0x240220e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91383883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x2101ab00,
      0x04efe2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81383888,
      0x813c3888,
+     0x240220e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2ef,
-     0xc907e023,
+     0xc907e03a,
      0xd107e110,
      0x04e2f0e8,
      0xc91fe80d,
@@ -283,28 +444,51 @@ const unsigned int PRU0code[] =  {
      0x00e3f0f0,
      0xd107fe06,
      0x1f07fefe,
-     0x21011a00,
+     0x2101bb00,
      0x00e4f0f0,
      0xc907fe02,
      0x1d07fefe,
-     0x21012d00,
+     0x2101e500,
      0xd107e706,
-     0xc907e60a,
+     0xc907e61b,
      0x04f0e2e3,
      0x81403883,
      0x10e2e2f0,
-     0x21012d00,
-     0xd107e605,
+     0x2101e500,
+     0xd107e616,
      0x04f0e2e4,
      0x81443884,
      0x10e2e2f0,
-     0x21012d00,
+     0x240250e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91403883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x2101e500,
      0x04f0e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81403888,
      0x81443888,
+     0x240250e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2f0,
      0xc908e010,
      0xd108e10f,
@@ -318,7 +502,7 @@ const unsigned int PRU0code[] =  {
      0x00e3f1f1,
      0xd10efe06,
      0x1f0efefe,
-     0x21013d00,
+     0x2101f500,
      0x00e4f1f1,
      0xc90efe02,
      0x1d0efefe,
@@ -334,69 +518,138 @@ const unsigned int PRU0code[] =  {
      0x00e3f2f2,
      0xd10ffe06,
      0x1f0ffefe,
-     0x21014d00,
+     0x21020500,
      0x00e4f2f2,
      0xc90ffe02,
      0x1d0ffefe,
-     0xc90ae014,
-     0xc90ae113,
+     0xc90ae02b,
+     0xc90ae12a,
      0xd10ee706,
-     0xc90ee60a,
+     0xc90ee61b,
      0x04f3e2e3,
      0x81583883,
      0x10e2e2f3,
-     0x21016100,
-     0xd10ee605,
+     0x21023000,
+     0xd10ee616,
      0x04f3e2e4,
      0x815c3884,
      0x10e2e2f3,
-     0x21016100,
+     0x2402e0e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91583883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x21023000,
      0x04f3e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81583888,
      0x815c3888,
+     0x2402e0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2f3,
-     0xc90be014,
-     0xc90be113,
+     0xc90be02b,
+     0xc90be12a,
      0xd10fe706,
-     0xc90fe60a,
+     0xc90fe61b,
      0x04f4e2e3,
      0x81603883,
      0x10e2e2f4,
-     0x21017500,
-     0xd10fe605,
+     0x21025b00,
+     0xd10fe616,
      0x04f4e2e4,
      0x81643884,
      0x10e2e2f4,
-     0x21017500,
+     0x240310e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91603883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x21025b00,
      0x04f4e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81603888,
      0x81643888,
+     0x240310e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2f4,
-     0xc90ce014,
-     0xc90ce113,
+     0xc90ce02b,
+     0xc90ce12a,
      0xd110e706,
-     0xc910e60a,
+     0xc910e61b,
      0x04f5e2e3,
      0x81683883,
      0x10e2e2f5,
-     0x21018900,
-     0xd110e605,
+     0x21028600,
+     0xd110e616,
      0x04f5e2e4,
      0x816c3884,
      0x10e2e2f5,
-     0x21018900,
+     0x240340e8,
+     0x92e87898,
+     0x5100f81d,
+     0x91683883,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83899,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x21028600,
      0x04f5e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81683888,
      0x816c3888,
+     0x240340e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83899,
+     0x0114e8e8,
+     0x82e83899,
      0x10e2e2f5,
      0x910c3a88,
      0x04e2e8e8,
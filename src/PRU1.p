@@ -94,7 +94,7 @@ procees_output_end:
 .endm
 
 .macro PROCESS_INPUT
-.mparam PIN, TON_OFFSET, TOFF_OFFSET, PREV_TOGGLE, LAST_STATE, CURRENT_STATE
+.mparam PIN, TON_OFFSET, TOFF_OFFSET, PREV_TOGGLE, LAST_STATE, CURRENT_STATE, AVG_OFFSET
 
   // Process high if pin is high, else process low
   QBBS in_high, CURRENT_STATE
@@ -123,6 +123,33 @@ procees_output_end:
     // Set previous toggle == current time
     MOV PREV_TOGGLE, CURRENT_TIME
 
+    // A full period has completed, skip averaging if window is zero
+    MOV TEMP, AVG_OFFSET
+    LBCO AVG_WINDOW, RAM, TEMP, 24
+    QBEQ process_input_end, AVG_WINDOW, 0
+
+    // Add Ton and period to the 64 bit sums
+    LBCO T_ON, RAM, TON_OFFSET, 4
+    ADD AVG_ON_LO, AVG_ON_LO, T_ON
+    ADC AVG_ON_HI, AVG_ON_HI, 0
+    ADD T_ON, T_ON, T_OFF
+    ADD AVG_PER_LO, AVG_PER_LO, T_ON
+    ADC AVG_PER_HI, AVG_PER_HI, 0
+    ADD AVG_COUNT, AVG_COUNT, 1
+
+    // Keep accumulating while count < window
+    ADD TEMP, TEMP, 4
+    QBLT average_store, AVG_WINDOW, AVG_COUNT
+
+    // Publish the sums in a single write and restart the window
+    ADD TEMP, TEMP, 20
+    SBCO AVG_COUNT, RAM, TEMP, 20
+    SUB TEMP, TEMP, 20
+    ZERO &AVG_COUNT, 20
+
+  average_store:
+    SBCO AVG_COUNT, RAM, TEMP, 20
+
     JMP process_input_end
 
 process_timeout:
@@ -136,6 +163,14 @@ process_timeout:
   SBCO TEMP, RAM, TON_OFFSET, 4
   SBCO TEMP, RAM, TOFF_OFFSET, 4
 
+  // Drop the partial and published averages
+  MOV TEMP, AVG_OFFSET
+  ADD TEMP, TEMP, 4
+  ZERO &AVG_COUNT, 20
+  SBCO AVG_COUNT, RAM, TEMP, 20
+  ADD TEMP, TEMP, 20
+  SBCO AVG_COUNT, RAM, TEMP, 20
+
   // Set previous toggle == current time
   // Though toggle not occured, still to avoid any garbage reading when pulse is restored
   MOV PREV_TOGGLE, CURRENT_TIME
@@ -220,7 +255,7 @@ PROCESS_MAIN:
 
 SKIP_P8_45_OUT:
     // Process input
-    PROCESS_INPUT P8_45_IN, P8_45_TON, P8_45_TOFF, P8_45_PREV_TOGGLE, P8_45_LAST_STATE, P8_45_CURRENT_STATE
+    PROCESS_INPUT P8_45_IN, P8_45_TON, P8_45_TOFF, P8_45_PREV_TOGGLE, P8_45_LAST_STATE, P8_45_CURRENT_STATE, P8_45_AVG
 
 SKIP_P8_45:
 
@@ -238,7 +273,7 @@ SKIP_P8_45:
 
 SKIP_P8_46_OUT:
     // Process input
-    PROCESS_INPUT P8_46_IN, P8_46_TON, P8_46_TOFF, P8_46_PREV_TOGGLE, P8_46_LAST_STATE, P8_46_CURRENT_STATE
+    PROCESS_INPUT P8_46_IN, P8_46_TON, P8_46_TOFF, P8_46_PREV_TOGGLE, P8_46_LAST_STATE, P8_46_CURRENT_STATE, P8_46_AVG
 
 SKIP_P8_46:
 
@@ -256,7 +291,7 @@ SKIP_P8_46:
 
 SKIP_P8_43_OUT:
     // Process input
-    PROCESS_INPUT P8_43_IN, P8_43_TON, P8_43_TOFF, P8_43_PREV_TOGGLE, P8_43_LAST_STATE, P8_43_CURRENT_STATE
+    PROCESS_INPUT P8_43_IN, P8_43_TON, P8_43_TOFF, P8_43_PREV_TOGGLE, P8_43_LAST_STATE, P8_43_CURRENT_STATE, P8_43_AVG
 
 SKIP_P8_43:
 
@@ -274,7 +309,7 @@ SKIP_P8_43:
 
 SKIP_P8_44_OUT:
     // Process input
-    PROCESS_INPUT P8_44_IN, P8_44_TON, P8_44_TOFF, P8_44_PREV_TOGGLE, P8_44_LAST_STATE, P8_44_CURRENT_STATE
+    PROCESS_INPUT P8_44_IN, P8_44_TON, P8_44_TOFF, P8_44_PREV_TOGGLE, P8_44_LAST_STATE, P8_44_CURRENT_STATE, P8_44_AVG
 
 SKIP_P8_44:
 
@@ -292,7 +327,7 @@ SKIP_P8_44:
 
 SKIP_P8_41_OUT:
     // Process input
-    PROCESS_INPUT P8_41_IN, P8_41_TON, P8_41_TOFF, P8_41_PREV_TOGGLE, P8_41_LAST_STATE, P8_41_CURRENT_STATE
+    PROCESS_INPUT P8_41_IN, P8_41_TON, P8_41_TOFF, P8_41_PREV_TOGGLE, P8_41_LAST_STATE, P8_41_CURRENT_STATE, P8_41_AVG
 
 SKIP_P8_41:
 
@@ -310,7 +345,7 @@ SKIP_P8_41:
 
 SKIP_P8_42_OUT:
     // Process input
-    PROCESS_INPUT P8_42_IN, P8_42_TON, P8_42_TOFF, P8_42_PREV_TOGGLE, P8_42_LAST_STATE, P8_42_CURRENT_STATE
+    PROCESS_INPUT P8_42_IN, P8_42_TON, P8_42_TOFF, P8_42_PREV_TOGGLE, P8_42_LAST_STATE, P8_42_CURRENT_STATE, P8_42_AVG
 
 SKIP_P8_42:
 
@@ -328,7 +363,7 @@ SKIP_P8_42:
 
 SKIP_P8_39_OUT:
     // Process input
-    PROCESS_INPUT P8_39_IN, P8_39_TON, P8_39_TOFF, P8_39_PREV_TOGGLE, P8_39_LAST_STATE, P8_39_CURRENT_STATE
+    PROCESS_INPUT P8_39_IN, P8_39_TON, P8_39_TOFF, P8_39_PREV_TOGGLE, P8_39_LAST_STATE, P8_39_CURRENT_STATE, P8_39_AVG
 
 SKIP_P8_39:
 
@@ -346,7 +381,7 @@ SKIP_P8_39:
 
 SKIP_P8_40_OUT:
     // Process input
-    PROCESS_INPUT P8_40_IN, P8_40_TON, P8_40_TOFF, P8_40_PREV_TOGGLE, P8_40_LAST_STATE, P8_40_CURRENT_STATE
+    PROCESS_INPUT P8_40_IN, P8_40_TON, P8_40_TOFF, P8_40_PREV_TOGGLE, P8_40_LAST_STATE, P8_40_CURRENT_STATE, P8_40_AVG
 
 SKIP_P8_40:
 
@@ -364,7 +399,7 @@ SKIP_P8_40:
 
 SKIP_P8_27_OUT:
     // Process input
-    PROCESS_INPUT P8_27_IN, P8_27_TON, P8_27_TOFF, P8_27_PREV_TOGGLE, P8_27_LAST_STATE, P8_27_CURRENT_STATE
+    PROCESS_INPUT P8_27_IN, P8_27_TON, P8_27_TOFF, P8_27_PREV_TOGGLE, P8_27_LAST_STATE, P8_27_CURRENT_STATE, P8_27_AVG
 
 SKIP_P8_27:
 
@@ -382,7 +417,7 @@ SKIP_P8_27:
 
 SKIP_P8_29_OUT:
     // Process input
-    PROCESS_INPUT P8_29_IN, P8_29_TON, P8_29_TOFF, P8_29_PREV_TOGGLE, P8_29_LAST_STATE, P8_29_CURRENT_STATE
+    PROCESS_INPUT P8_29_IN, P8_29_TON, P8_29_TOFF, P8_29_PREV_TOGGLE, P8_29_LAST_STATE, P8_29_CURRENT_STATE, P8_29_AVG
 
 SKIP_P8_29:
 
@@ -400,7 +435,7 @@ SKIP_P8_29:
 
 SKIP_P8_28_OUT:
     // Process input
-    PROCESS_INPUT P8_28_IN, P8_28_TON, P8_28_TOFF, P8_28_PREV_TOGGLE, P8_28_LAST_STATE, P8_28_CURRENT_STATE
+    PROCESS_INPUT P8_28_IN, P8_28_TON, P8_28_TOFF, P8_28_PREV_TOGGLE, P8_28_LAST_STATE, P8_28_CURRENT_STATE, P8_28_AVG
 
 SKIP_P8_28:
 
@@ -418,7 +453,7 @@ SKIP_P8_28:
 
 SKIP_P8_30_OUT:
     // Process input
-    PROCESS_INPUT P8_30_IN, P8_30_TON, P8_30_TOFF, P8_30_PREV_TOGGLE, P8_30_LAST_STATE, P8_30_CURRENT_STATE
+    PROCESS_INPUT P8_30_IN, P8_30_TON, P8_30_TOFF, P8_30_PREV_TOGGLE, P8_30_LAST_STATE, P8_30_CURRENT_STATE, P8_30_AVG
 
 SKIP_P8_30:
 
@@ -436,7 +471,7 @@ SKIP_P8_30:
 
 SKIP_P8_21_OUT:
     // Process input
-    PROCESS_INPUT P8_21_IN, P8_21_TON, P8_21_TOFF, P8_21_PREV_TOGGLE, P8_21_LAST_STATE, P8_21_CURRENT_STATE
+    PROCESS_INPUT P8_21_IN, P8_21_TON, P8_21_TOFF, P8_21_PREV_TOGGLE, P8_21_LAST_STATE, P8_21_CURRENT_STATE, P8_21_AVG
 
 SKIP_P8_21:
 
@@ -454,7 +489,7 @@ SKIP_P8_21:
 
 SKIP_P8_20_OUT:
     // Process input
-    PROCESS_INPUT P8_20_IN, P8_20_TON, P8_20_TOFF, P8_20_PREV_TOGGLE, P8_20_LAST_STATE, P8_20_CURRENT_STATE
+    PROCESS_INPUT P8_20_IN, P8_20_TON, P8_20_TOFF, P8_20_PREV_TOGGLE, P8_20_LAST_STATE, P8_20_CURRENT_STATE, P8_20_AVG
 
 SKIP_P8_20:
 
@@ -467,7 +502,7 @@ SKIP_P8_20:
   QBBC SKIP_P9_26, P9_26_MODE
 
     // Process input
-    PROCESS_INPUT P9_26_IN, P9_26_TON, P9_26_TOFF, P9_26_PREV_TOGGLE, P9_26_LAST_STATE, P9_26_CURRENT_STATE
+    PROCESS_INPUT P9_26_IN, P9_26_TON, P9_26_TOFF, P9_26_PREV_TOGGLE, P9_26_LAST_STATE, P9_26_CURRENT_STATE, P9_26_AVG
 
 SKIP_P9_26:
 
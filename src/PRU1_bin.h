@@ -28,7 +28,7 @@ const unsigned int PRU1code[] =  {
      0x910c3a82,
      0x91e83985,
      0x10ffffe7,
-     0xc90de023,
+     0xc90de03a,
      0xd10de110,
      0x04e2e9e8,
      0xc91fe80d,
@@ -44,26 +44,49 @@ const unsigned int PRU1code[] =  {
      0x00e4e9e9,
      0xc900fe02,
      0x1d00fefe,
-     0x21003a00,
+     0x21005100,
      0xd100e706,
-     0xc900e60a,
+     0xc900e61b,
      0x04e9e2e3,
      0x81703983,
      0x10e2e2e9,
-     0x21003a00,
-     0xd100e605,
+     0x21005100,
+     0xd100e616,
      0x04e9e2e4,
      0x81743984,
      0x10e2e2e9,
-     0x21003a00,
+     0x240370e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91703983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21005100,
      0x04e9e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81703988,
      0x81743988,
+     0x240370e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2e9,
-     0xc90ee023,
+     0xc90ee03a,
      0xd10ee110,
      0x04e2eae8,
      0xc91fe80d,
@@ -75,30 +98,53 @@ const unsigned int PRU1code[] =  {
      0x00e3eaea,
      0xd101fe06,
      0x1f01fefe,
-     0x21004a00,
+     0x21006100,
      0x00e4eaea,
      0xc901fe02,
      0x1d01fefe,
-     0x21005d00,
+     0x21008b00,
      0xd101e706,
-     0xc901e60a,
+     0xc901e61b,
      0x04eae2e3,
      0x81783983,
      0x10e2e2ea,
-     0x21005d00,
-     0xd101e605,
+     0x21008b00,
+     0xd101e616,
      0x04eae2e4,
      0x817c3984,
      0x10e2e2ea,
-     0x21005d00,
+     0x2403a0e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91783983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21008b00,
      0x04eae2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81783988,
      0x817c3988,
+     0x2403a0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2ea,
-     0xc90fe023,
+     0xc90fe03a,
      0xd10fe110,
      0x04e2ebe8,
      0xc91fe80d,
@@ -110,30 +156,53 @@ const unsigned int PRU1code[] =  {
      0x00e3ebeb,
      0xd102fe06,
      0x1f02fefe,
-     0x21006d00,
+     0x21009b00,
      0x00e4ebeb,
      0xc902fe02,
      0x1d02fefe,
-     0x21008000,
+     0x2100c500,
      0xd102e706,
-     0xc902e60a,
+     0xc902e61b,
      0x04ebe2e3,
      0x81803983,
      0x10e2e2eb,
-     0x21008000,
-     0xd102e605,
+     0x2100c500,
+     0xd102e616,
      0x04ebe2e4,
      0x81843984,
      0x10e2e2eb,
-     0x21008000,
+     0x2403d0e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91803983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x2100c500,
      0x04ebe2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81803988,
      0x81843988,
+     0x2403d0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2eb,
-     0xc910e023,
+     0xc910e03a,
      0xd110e110,
      0x04e2ece8,
      0xc91fe80d,
@@ -145,30 +214,53 @@ const unsigned int PRU1code[] =  {
      0x00e3ecec,
      0xd103fe06,
      0x1f03fefe,
-     0x21009000,
+     0x2100d500,
      0x00e4ecec,
      0xc903fe02,
      0x1d03fefe,
-     0x2100a300,
+     0x2100ff00,
      0xd103e706,
-     0xc903e60a,
+     0xc903e61b,
      0x04ece2e3,
      0x81883983,
      0x10e2e2ec,
-     0x2100a300,
-     0xd103e605,
+     0x2100ff00,
+     0xd103e616,
      0x04ece2e4,
      0x818c3984,
      0x10e2e2ec,
-     0x2100a300,
+     0x240400e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91883983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x2100ff00,
      0x04ece2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81883988,
      0x818c3988,
+     0x240400e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2ec,
-     0xc911e023,
+     0xc911e03a,
      0xd111e110,
      0x04e2ede8,
      0xc91fe80d,
@@ -180,30 +272,53 @@ const unsigned int PRU1code[] =  {
      0x00e3eded,
      0xd104fe06,
      0x1f04fefe,
-     0x2100b300,
+     0x21010f00,
      0x00e4eded,
      0xc904fe02,
      0x1d04fefe,
-     0x2100c600,
+     0x21013900,
      0xd104e706,
-     0xc904e60a,
+     0xc904e61b,
      0x04ede2e3,
      0x81903983,
      0x10e2e2ed,
-     0x2100c600,
-     0xd104e605,
+     0x21013900,
+     0xd104e616,
      0x04ede2e4,
      0x81943984,
      0x10e2e2ed,
-     0x2100c600,
+     0x240430e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91903983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21013900,
      0x04ede2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81903988,
      0x81943988,
+     0x240430e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2ed,
-     0xc912e023,
+     0xc912e03a,
      0xd112e110,
      0x04e2eee8,
      0xc91fe80d,
@@ -215,30 +330,53 @@ const unsigned int PRU1code[] =  {
      0x00e3eeee,
      0xd105fe06,
      0x1f05fefe,
-     0x2100d600,
+     0x21014900,
      0x00e4eeee,
      0xc905fe02,
      0x1d05fefe,
-     0x2100e900,
+     0x21017300,
      0xd105e706,
-     0xc905e60a,
+     0xc905e61b,
      0x04eee2e3,
      0x81983983,
      0x10e2e2ee,
-     0x2100e900,
-     0xd105e605,
+     0x21017300,
+     0xd105e616,
      0x04eee2e4,
      0x819c3984,
      0x10e2e2ee,
-     0x2100e900,
+     0x240460e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91983983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21017300,
      0x04eee2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81983988,
      0x819c3988,
+     0x240460e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2ee,
-     0xc913e023,
+     0xc913e03a,
      0xd113e110,
      0x04e2efe8,
      0xc91fe80d,
@@ -250,30 +388,53 @@ const unsigned int PRU1code[] =  {
      0x00e3efef,
      0xd106fe06,
      0x1f06fefe,
-     0x2100f900,
+     0x21018300,
      0x00e4efef,
      0xc906fe02,
      0x1d06fefe,
-     0x21010c00,
+     0x2101ad00,
      0xd106e706,
-     0xc906e60a,
+     0xc906e61b,
      0x04efe2e3,
      0x81a03983,
      0x10e2e2ef,
-     0x21010c00,
-     0xd106e605,
+     0x2101ad00,
+     0xd106e616,
      0x04efe2e4,
      0x81a43984,
      0x10e2e2ef,
-     0x21010c00,
+     0x240490e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91a03983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x2101ad00,
      0x04efe2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81a03988,
      0x81a43988,
+     0x240490e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2ef,
-     0xc914e023,
+     0xc914e03a,
      0xd114e110,
      0x04e2f0e8,
      0xc91fe80d,
@@ -285,30 +446,53 @@ const unsigned int PRU1code[] =  {
      0x00e3f0f0,
      0xd107fe06,
      0x1f07fefe,
-     0x21011c00,
+     0x2101bd00,
      0x00e4f0f0,
      0xc907fe02,
      0x1d07fefe,
-     0x21012f00,
+     0x2101e700,
      0xd107e706,
-     0xc907e60a,
+     0xc907e61b,
      0x04f0e2e3,
      0x81a83983,
      0x10e2e2f0,
-     0x21012f00,
-     0xd107e605,
+     0x2101e700,
+     0xd107e616,
      0x04f0e2e4,
      0x81ac3984,
      0x10e2e2f0,
-     0x21012f00,
+     0x2404c0e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91a83983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x2101e700,
      0x04f0e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81a83988,
      0x81ac3988,
+     0x2404c0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2f0,
-     0xc915e023,
+     0xc915e03a,
      0xd115e110,
      0x04e2f1e8,
      0xc91fe80d,
@@ -320,30 +504,53 @@ const unsigned int PRU1code[] =  {
      0x00e3f1f1,
      0xd108fe06,
      0x1f08fefe,
-     0x21013f00,
+     0x2101f700,
      0x00e4f1f1,
      0xc908fe02,
      0x1d08fefe,
-     0x21015200,
+     0x21022100,
      0xd108e706,
-     0xc908e60a,
+     0xc908e61b,
      0x04f1e2e3,
      0x81b03983,
      0x10e2e2f1,
-     0x21015200,
-     0xd108e605,
+     0x21022100,
+     0xd108e616,
      0x04f1e2e4,
      0x81b43984,
      0x10e2e2f1,
-     0x21015200,
+     0x2404f0e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91b03983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21022100,
      0x04f1e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81b03988,
      0x81b43988,
+     0x2404f0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2f1,
-     0xc916e023,
+     0xc916e03a,
      0xd116e110,
      0x04e2f2e8,
      0xc91fe80d,
@@ -355,30 +562,53 @@ const unsigned int PRU1code[] =  {
      0x00e3f2f2,
      0xd109fe06,
      0x1f09fefe,
-     0x21016200,
+     0x21023100,
      0x00e4f2f2,
      0xc909fe02,
      0x1d09fefe,
-     0x21017500,
+     0x21025b00,
      0xd109e706,
-     0xc909e60a,
+     0xc909e61b,
      0x04f2e2e3,
      0x81b83983,
      0x10e2e2f2,
-     0x21017500,
-     0xd109e605,
+     0x21025b00,
+     0xd109e616,
      0x04f2e2e4,
      0x81bc3984,
      0x10e2e2f2,
-     0x21017500,
+     0x240520e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91b83983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21025b00,
      0x04f2e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81b83988,
      0x81bc3988,
+     0x240520e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2f2,
-     0xc917e023,
+     0xc917e03a,
      0xd117e110,
      0x04e2f3e8,
      0xc91fe80d,
@@ -390,30 +620,53 @@ const unsigned int PRU1code[] =  {
      0x00e3f3f3,
      0xd10afe06,
      0x1f0afefe,
-     0x21018500,
+     0x21026b00,
      0x00e4f3f3,
      0xc90afe02,
      0x1d0afefe,
-     0x21019800,
+     0x21029500,
      0xd10ae706,
-     0xc90ae60a,
+     0xc90ae61b,
      0x04f3e2e3,
      0x81c03983,
      0x10e2e2f3,
-     0x21019800,
-     0xd10ae605,
+     0x21029500,
+     0xd10ae616,
      0x04f3e2e4,
      0x81c43984,
      0x10e2e2f3,
-     0x21019800,
+     0x240550e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91c03983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21029500,
      0x04f3e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81c03988,
      0x81c43988,
+     0x240550e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2f3,
-     0xc918e023,
+     0xc918e03a,
      0xd118e110,
      0x04e2f4e8,
      0xc91fe80d,
@@ -425,30 +678,53 @@ const unsigned int PRU1code[] =  {
      0x00e3f4f4,
      0xd10bfe06,
      0x1f0bfefe,
-     0x2101a800,
+     0x2102a500,
      0x00e4f4f4,
      0xc90bfe02,
      0x1d0bfefe,
-     0x2101bb00,
+     0x2102cf00,
      0xd10be706,
-     0xc90be60a,
+     0xc90be61b,
      0x04f4e2e3,
      0x81c83983,
      0x10e2e2f4,
-     0x2101bb00,
-     0xd10be605,
+     0x2102cf00,
+     0xd10be616,
      0x04f4e2e4,
      0x81cc3984,
      0x10e2e2f4,
-     0x2101bb00,
+     0x240580e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91c83983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x2102cf00,
      0x04f4e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81c83988,
      0x81cc3988,
+     0x240580e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2f4,
-     0xc919e023,
+     0xc919e03a,
      0xd119e110,
      0x04e2f5e8,
      0xc91fe80d,
@@ -460,30 +736,53 @@ const unsigned int PRU1code[] =  {
      0x00e3f5f5,
      0xd10cfe06,
      0x1f0cfefe,
-     0x2101cb00,
+     0x2102df00,
      0x00e4f5f5,
      0xc90cfe02,
      0x1d0cfefe,
-     0x2101de00,
+     0x21030900,
      0xd10ce706,
-     0xc90ce60a,
+     0xc90ce61b,
      0x04f5e2e3,
      0x81d03983,
      0x10e2e2f5,
-     0x2101de00,
-     0xd10ce605,
+     0x21030900,
+     0xd10ce616,
      0x04f5e2e4,
      0x81d43984,
      0x10e2e2f5,
-     0x2101de00,
+     0x2405b0e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91d03983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21030900,
      0x04f5e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81d03988,
      0x81d43988,
+     0x2405b0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2f5,
-     0xc91ae023,
+     0xc91ae03a,
      0xd11ae110,
      0x04e2f6e8,
      0xc91fe80d,
@@ -495,48 +794,94 @@ const unsigned int PRU1code[] =  {
      0x00e3f6f6,
      0xd10dfe06,
      0x1f0dfefe,
-     0x2101ee00,
+     0x21031900,
      0x00e4f6f6,
      0xc90dfe02,
      0x1d0dfefe,
-     0x21020100,
+     0x21034300,
      0xd10de706,
-     0xc90de60a,
+     0xc90de61b,
      0x04f6e2e3,
      0x81d83983,
      0x10e2e2f6,
-     0x21020100,
-     0xd10de605,
+     0x21034300,
+     0xd10de616,
      0x04f6e2e4,
      0x81dc3984,
      0x10e2e2f6,
-     0x21020100,
+     0x2405e0e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91d83983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21034300,
      0x04f6e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81d83988,
      0x81dc3988,
+     0x2405e0e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2f6,
-     0xc91be014,
-     0xc91be113,
+     0xc91be02b,
+     0xc91be12a,
      0xd110e706,
-     0xc910e60a,
+     0xc910e61b,
      0x04f7e2e3,
      0x81e03983,
      0x10e2e2f7,
-     0x21021500,
-     0xd110e605,
+     0x21036e00,
+     0xd110e616,
      0x04f7e2e4,
      0x81e43984,
      0x10e2e2f7,
-     0x21021500,
+     0x240610e8,
+     0x92e87998,
+     0x5100f81d,
+     0x91e03983,
+     0x00e3fafa,
+     0x0300fbfb,
+     0x00e4e3e3,
+     0x00e3fcfc,
+     0x0300fdfd,
+     0x0101f9f9,
+     0x0104e8e8,
+     0x48f9f805,
+     0x0114e8e8,
+     0x82e83999,
+     0x0514e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x21036e00,
      0x04f7e2e8,
      0x04e8e5e8,
-     0xc91fe805,
+     0xc91fe80b,
      0x240000e8,
      0x81e03988,
      0x81e43988,
+     0x240610e8,
+     0x0104e8e8,
+     0x2eff8999,
+     0x82e83999,
+     0x0114e8e8,
+     0x82e83999,
      0x10e2e2f7,
      0x910c3a88,
      0x04e2e8e8,
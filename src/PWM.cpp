@@ -26,7 +26,8 @@
 #include <stdint.h>
 #include <errno.h>
 #include <sys/mman.h>
-#include <pthread.h>
+#include <dirent.h>
+#include <limits.h>
 #include <iostream>
 #include <cstdio>
 #include <cstdlib>
@@ -38,10 +39,9 @@
 #include "PRU1_bin.h"
 #include "OVERLAY.h"
 
-PRU::PRU() {
-    pthread_t thread;
+PRU::PRU() : watchdogTimer(0) {
     pruInit();
-    pthread_create(&thread, NULL, resetWatchdogPRU, (void*)1000);
+    resetWatchdog(WATCHDOG_KICK_INTERVAL);
 }
 
 int PRU::gpioNumToPruMap(uint8_t num)
@@ -80,71 +80,225 @@ int PRU::gpioNumToPruMap(uint8_t num)
   }
 }
 
+static uint32_t crc32(const uint32_t *words, uint32_t count)
+{
+  const uint8_t *data = (const uint8_t*) words;
+  uint32_t crc = 0xffffffff;
+  for(uint32_t index = 0; index < count * 4; index++)
+  {
+    crc ^= data[index];
+    for(int bit = 0; bit < 8; bit++)
+    crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
+
 void PRU::pruInit()
 {
-  unsigned int index;
   uint32_t fd;
-  volatile uint32_t *iram0, *iram1;
-  volatile uint8_t *iep, *ctrl0, *ctrl1;
+  volatile uint8_t *iep;
 
   if((fd = open("/dev/mem",O_RDWR|O_SYNC))<1)
   perror("Device memory open failed\n");
 
   pru = (struct pru*) mmap(0, 0x2000,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, PRU_RAM0_BASE);
   iep = (uint8_t*) mmap(0, 0x68,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, PRU_IEP_BASE);
-  iram0 = (uint32_t*) mmap(0, 0x2000,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, PRU0_IRAM_BASE);
-  iram1 = (uint32_t*) mmap(0, 0x2000,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, PRU1_IRAM_BASE);
-  ctrl0 = (uint8_t*) mmap(0, 0x30,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, PRU0_CTRL_BASE);
-  ctrl1 = (uint8_t*) mmap(0, 0x30,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, PRU1_CTRL_BASE);
-  if(((void *)pru== NULL)||((void *)iep== NULL)||((void *)iram0== NULL)||((void *)iram1== NULL)||((void *)ctrl0== NULL)||((void *)ctrl1== NULL))
+  if(((void *)pru== NULL)||((void *)iep== NULL))
   perror("PRU memory map open failed\n");
 
   close(fd);
 
-  *(ctrl0 + CONTROL) = (1 << SOFT_RST_N);
-  *(ctrl1 + CONTROL) = (1 << SOFT_RST_N);
+  // A PRU still running an image from an earlier host process keeps its outputs,
+  // so the shared RAM is only reset when both PRUs start from a stopped state
+  int count;
+  if(firmwareRunning(PRU0) || firmwareRunning(PRU1))
+  {
+    for(count=0; count < PIN_COUNT; count++)
+    timePeriod[count] = pru -> pwm_pin[count].t_on + pru -> pwm_pin[count].t_off;
+  }
+  else
+  {
+    pru -> enable = 0x0;
+    pru -> mode = 0x0;
 
-  pru -> enable = 0x0;
-  pru -> mode = 0x0;
+    for(count=0; count < PIN_COUNT; count++)
+    {
+      pru -> pwm_pin[count].t_on  = DEFAULT_PULSE_WIDTH * 200;
+      pru -> pwm_pin[count].t_off = (DEFAULT_TIME_PERIOD * 200 - DEFAULT_PULSE_WIDTH * 200);
+      timePeriod[count] = DEFAULT_TIME_PERIOD * 200;
+    }
 
-  int count;
-  for(count=0; count < PIN_COUNT; count++)
+    pru -> timeout = 10 * (DEFAULT_TIME_PERIOD * 200);
+
+    pru -> failsafe_t_on  = DEFAULT_PULSE_WIDTH * 200;
+    pru -> failsafe_t_off = (DEFAULT_TIME_PERIOD * 200 - DEFAULT_PULSE_WIDTH * 200);
+  }
+
+  // Images on disk take precedence over the compiled-in firmware
+  if(loadFirmware(PRU0, PRU0_FIRMWARE) < 0)
+  loadFirmware(PRU0, PRU0code, sizeof(PRU0code)/sizeof(unsigned int));
+  if(loadFirmware(PRU1, PRU1_FIRMWARE) < 0)
+  loadFirmware(PRU1, PRU1code, sizeof(PRU1code)/sizeof(unsigned int));
+
+  // Restarting the counter under a running PRU would disturb its timing
+  if(!(*(iep + GLOBAL_CFG) & (1 << CNT_ENABLE)))
   {
-    pru -> pwm_pin[count].t_on  = DEFAULT_PULSE_WIDTH * 200;
-    pru -> pwm_pin[count].t_off = (DEFAULT_TIME_PERIOD * 200 - DEFAULT_PULSE_WIDTH * 200);
-    timePeriod[count] = DEFAULT_TIME_PERIOD * 200;
+    *(iep + GLOBAL_CFG) = (1 << DEFAULT_INC);
+    *(iep + COUNT) = 0x0;
+    *(iep + GLOBAL_CFG) = *(iep + GLOBAL_CFG) | (1 << CNT_ENABLE);
   }
 
-  pru -> timeout = 10 * (DEFAULT_TIME_PERIOD * 200);
+  munmap((void*)iep, 0x68);
+}
 
-  pru -> failsafe_t_on  = DEFAULT_PULSE_WIDTH * 200;
-  pru -> failsafe_t_off = (DEFAULT_TIME_PERIOD * 200 - DEFAULT_PULSE_WIDTH * 200);
+// True if the PRU runs and its load record is set, i.e. a verified image is executing
+bool PRU::firmwareRunning(uint8_t pruNum)
+{
+  uint32_t fd;
+  volatile uint32_t *ctrl, *tag;
+  bool running;
 
-  for(index = 0; index < sizeof(PRU0code)/sizeof(unsigned int); index++)
-  *(iram0 + index) = PRU0code[index];
+  tag = (volatile uint32_t*)((volatile uint8_t*) pru + PRU_FIRMWARE_TAG) + pruNum * 2;
+  if((fd = open("/dev/mem",O_RDWR|O_SYNC))<1)
+  return false;
+  ctrl = (uint32_t*) mmap(0, 0x30,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, pruNum == PRU0 ? PRU0_CTRL_BASE : PRU1_CTRL_BASE);
+  close(fd);
+  if(ctrl == MAP_FAILED)
+  return false;
 
-  for(index = 0; index < sizeof(PRU1code)/sizeof(unsigned int); index++)
-  *(iram1 + index) = PRU1code[index];
+  running = (*(ctrl + CONTROL) & (1 << RUNSTATE)) && tag[1] != 0;
+  munmap((void*)ctrl, 0x30);
+  return running;
+}
 
-  *(iep + GLOBAL_CFG) = (1 << DEFAULT_INC);
-  *(iep + COUNT) = 0x0;
-  *(iep + GLOBAL_CFG) |= (1 << CNT_ENABLE);
+int PRU::loadFirmware(uint8_t pruNum, const char *path)
+{
+  FILE *file;
+  long size;
+  uint32_t header[3], *code;
+  uint32_t words, offset = 0;
+  int result;
 
-  *(ctrl0 + CONTROL) = (1 << ENABLE);
-  *(ctrl1 + CONTROL) = (1 << ENABLE);
+  if((file = fopen(path, "rb")) == NULL)
+  return -1;
 
-  munmap((void*)iep, 0x68);
-  munmap((void*)iram0, 0x2000);
-  munmap((void*)iram1, 0x2000);
-  munmap((void*)ctrl0, 0x30);
-  munmap((void*)ctrl1, 0x30);
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  // A header is optional so plain pasm -b output can be dropped in as is
+  if(size >= (long)sizeof(header) && fread(header, sizeof(header), 1, file) == 1 && header[0] == PRU_FIRMWARE_MAGIC)
+  {
+    offset = sizeof(header);
+    if(header[1] != (uint32_t)(size - offset))
+    {
+      perror("PRU firmware length mismatch");
+      fclose(file);
+      return -1;
+    }
+  }
+  fseek(file, offset, SEEK_SET);
+
+  size -= offset;
+  if(size <= 0 || size % 4 || size > PRU_IRAM_SIZE)
+  {
+    perror("Invalid PRU firmware size");
+    fclose(file);
+    return -1;
+  }
+
+  words = size / 4;
+  code = (uint32_t*) malloc(size);
+  if(code == NULL || fread(code, 4, words, file) != words)
+  {
+    perror("PRU firmware read failed");
+    free(code);
+    fclose(file);
+    return -1;
+  }
+  fclose(file);
+
+  if(offset && crc32(code, words) != header[2])
+  {
+    perror("PRU firmware checksum mismatch");
+    free(code);
+    return -1;
+  }
+
+  result = loadFirmware(pruNum, code, words);
+  free(code);
+  return result;
+}
+
+// Only the control block of the target PRU is touched, so the other PRU and the
+// shared data RAM keep driving their outputs while one image is swapped
+int PRU::loadFirmware(uint8_t pruNum, const uint32_t *code, uint32_t words)
+{
+  uint32_t fd, index, crc;
+  volatile uint32_t *iram, *ctrl, *tag;
+
+  if(pruNum > PRU1 || words == 0 || words > PRU_IRAM_SIZE / 4)
+  {
+    perror("Invalid PRU firmware");
+    return -1;
+  }
+
+  crc = crc32(code, words);
+  tag = (volatile uint32_t*)((volatile uint8_t*) pru + PRU_FIRMWARE_TAG) + pruNum * 2;
+
+  if((fd = open("/dev/mem",O_RDWR|O_SYNC))<1)
+  {
+    perror("Device memory open failed\n");
+    return -1;
+  }
+
+  iram = (uint32_t*) mmap(0, PRU_IRAM_SIZE,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, pruNum == PRU0 ? PRU0_IRAM_BASE : PRU1_IRAM_BASE);
+  ctrl = (uint32_t*) mmap(0, 0x30,   PROT_WRITE|PROT_READ,MAP_SHARED, fd, pruNum == PRU0 ? PRU0_CTRL_BASE : PRU1_CTRL_BASE);
+  close(fd);
+  if((iram == MAP_FAILED)||(ctrl == MAP_FAILED))
+  {
+    perror("PRU memory map open failed\n");
+    return -1;
+  }
+
+  // IRAM cannot be read back while the PRU runs, so the record left by the last load decides
+  if((*(ctrl + CONTROL) & (1 << RUNSTATE)) && tag[0] == crc && tag[1] == words)
+  {
+    munmap((void*)iram, PRU_IRAM_SIZE);
+    munmap((void*)ctrl, 0x30);
+    return 0;
+  }
+
+  *(ctrl + CONTROL) = (1 << SOFT_RST_N);
+  tag[0] = 0;
+  tag[1] = 0;
+
+  for(index = 0; index < words; index++)
+  *(iram + index) = code[index];
+
+  for(index = 0; index < words; index++)
+  if(*(iram + index) != code[index])
+  break;
+
+  if(index == words)
+  {
+    tag[0] = crc;
+    tag[1] = words;
+    *(ctrl + CONTROL) = (1 << ENABLE);
+  }
+  else
+  perror("PRU firmware verify failed");
+
+  munmap((void*)iram, PRU_IRAM_SIZE);
+  munmap((void*)ctrl, 0x30);
+  return index == words ? 1 : -1;
 }
 
 int PRU::pruConfig(uint8_t gpioPin, uint8_t pin_mode)
 {
   uint8_t pin = gpioNumToPruMap(gpioPin);
-  pru -> enable |= (1 << pin);
-  pru -> mode |= (pin_mode << pin);
+  pru -> enable = pru -> enable | (1 << pin);
+  pru -> mode = pru -> mode | (pin_mode << pin);
   return gpioPin;
 }
 
@@ -210,6 +364,20 @@ void PRU::setPulseWidth (uint8_t gpioPin, uint32_t period_us)
   perror("Invalid pulse width");
 }
 
+// PRU timing is counted in 5 ns IEP ticks
+void PRU::setPulseWidthns (uint8_t gpioPin, uint32_t period_ns)
+{
+  uint8_t pin = gpioNumToPruMap(gpioPin);
+  uint32_t value = period_ns / 5;
+  if(value <= timePeriod[pin])
+  {
+    pru -> pwm_pin[pin].t_on  = value;
+    pru -> pwm_pin[pin].t_off = (timePeriod[pin] - value);
+  }
+  else
+  perror("Invalid pulse width");
+}
+
 uint32_t PRU::getPulseWidth (uint8_t gpioPin)
 {
   uint8_t pin = gpioNumToPruMap(gpioPin);
@@ -240,6 +408,80 @@ uint32_t PRU::getDutyPercentage (uint8_t gpioPin)
   return percentage;
 }
 
+void PRU::setAveragingWindow (uint8_t gpioPin, uint32_t periods)
+{
+  int pin = gpioNumToPruMap(gpioPin);
+  if(pin < 0)
+  return;
+  if(periods > MAX_AVERAGING_WINDOW)
+  {
+    perror("Invalid averaging window");
+    periods = MAX_AVERAGING_WINDOW;
+  }
+  pru -> average[pin].window = periods;
+}
+
+// Sums over the last published window in 5 ns ticks, or the latest single period if none
+bool PRU::readAverage (uint8_t gpioPin, uint32_t &count, uint64_t &on, uint64_t &period)
+{
+  int pin = gpioNumToPruMap(gpioPin);
+  if(pin < 0)
+  return false;
+
+  // The PRU publishes with one burst write, read until two copies agree to rule out tearing
+  for(int attempt = 0; attempt < 4; attempt++)
+  {
+    count  = pru -> average[pin].result.count;
+    on     = ((uint64_t)pru -> average[pin].result.on_hi << 32) | pru -> average[pin].result.on_lo;
+    period = ((uint64_t)pru -> average[pin].result.period_hi << 32) | pru -> average[pin].result.period_lo;
+    if(count  == pru -> average[pin].result.count &&
+       on     == (((uint64_t)pru -> average[pin].result.on_hi << 32) | pru -> average[pin].result.on_lo) &&
+       period == (((uint64_t)pru -> average[pin].result.period_hi << 32) | pru -> average[pin].result.period_lo))
+    break;
+  }
+
+  if(count == 0 || pru -> average[pin].window == 0)
+  {
+    count  = 1;
+    on     = pru -> pwm_pin[pin].t_on;
+    period = on + pru -> pwm_pin[pin].t_off;
+  }
+  return period != 0;
+}
+
+uint64_t PRU::getFrequencymHz (uint8_t gpioPin)
+{
+  uint32_t count;
+  uint64_t on, period;
+  if(!readAverage(gpioPin, count, on, period))
+  return 0;
+  return (count * 200000000000ULL + period / 2) / period;
+}
+
+uint32_t PRU::getDutyppm (uint8_t gpioPin)
+{
+  uint32_t count;
+  uint64_t on, period;
+  if(!readAverage(gpioPin, count, on, period))
+  return 0;
+  // Scale both sums down so on * 1000000 cannot overflow
+  while(period >> 44)
+  {
+    on >>= 1;
+    period >>= 1;
+  }
+  return (on * 1000000 + period / 2) / period;
+}
+
+uint64_t PRU::getTimePeriodns (uint8_t gpioPin)
+{
+  uint32_t count;
+  uint64_t on, period;
+  if(!readAverage(gpioPin, count, on, period))
+  return 0;
+  return (period * 5 + count / 2) / count;
+}
+
 void PRU::setPulseReadTimeout (uint32_t time_us)
 {
   uint32_t value;
@@ -253,18 +495,22 @@ void PRU::setFailsafePRU (uint32_t pulseWidth_us, uint32_t timePeriod_us)
   pru -> failsafe_t_off = (timePeriod_us * 200 - pulseWidth_us * 200);
 }
 
+// Kicks the watchdog every interval us from the shared timer wheel instead of a dedicated thread
 void PRU::resetWatchdog (long interval)
 {
-  while(1)
-  {
-    pru -> watchdog = 0x0;
-    usleep(interval);
-  }
+  uint32_t interval_ms = interval > 1000 ? interval / 1000 : 1;
+
+  if(watchdogTimer)
+  timerWheel()->cancel(watchdogTimer);
+  pru -> watchdog = 0x0;
+  watchdogTimer = timerWheel()->schedulePeriodic(interval_ms, [this] { pru -> watchdog = 0x0; });
 }
 
 PRU::~PRU()
 {
   int count;
+  // A kick already running writes through pru, let it finish before the PRU goes away
+  timerWheel()->cancelAndWait(watchdogTimer);
   for(count=0; count < PIN_COUNT; count++)
   {
     pru -> pwm_pin[count].t_on = DEFAULT_PULSE_WIDTH * 200;
@@ -275,93 +521,335 @@ PRU::~PRU()
 PRU *_pru;
 
 
+// ePWM/eCAP blocks of the PWMSS, identified by their register base in the device path
+static const struct { uint32_t address; const char *name; } pwmBlocks[PWM_BLOCK_COUNT] =
+{
+  { 0x48300100, "ecap0"   },
+  { 0x48300200, "ehrpwm0" },
+  { 0x48302100, "ecap1"   },
+  { 0x48302200, "ehrpwm1" },
+  { 0x48304100, "ecap2"   },
+  { 0x48304200, "ehrpwm2" },
+};
+
+// Header pins routed to each block output (block index, channel)
+static const struct { uint8_t gpio; uint8_t block; uint8_t channel; } pwmPins[PWM_PIN_COUNT] =
+{
+  {   2, 1, 0 },  // P9_22 ehrpwm0A
+  { 110, 1, 0 },  // P9_31 ehrpwm0A
+  {   3, 1, 1 },  // P9_21 ehrpwm0B
+  { 111, 1, 1 },  // P9_29 ehrpwm0B
+  {   7, 0, 0 },  // P9_42 ecap0
+  {  50, 3, 0 },  // P9_14 ehrpwm1A
+  {  80, 3, 0 },  // P8_36 ehrpwm1A
+  {  51, 3, 1 },  // P9_16 ehrpwm1B
+  {  81, 3, 1 },  // P8_34 ehrpwm1B
+  {  22, 5, 0 },  // P8_19 ehrpwm2A
+  {  70, 5, 0 },  // P8_45 ehrpwm2A
+  {  23, 5, 1 },  // P8_13 ehrpwm2B
+  {  71, 5, 1 },  // P8_46 ehrpwm2B
+  { 113, 4, 0 },  // P9_28 ecap2
+};
+
+struct pwmTopologyHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t blocks;
+  uint32_t chipCount;
+};
+
+struct pwmTopologyEntry {
+  int32_t chip;
+  uint32_t linkHash;
+};
+
+// FNV-1a, enough to notice a chip moving to another device node
+static uint32_t pwmLinkHash(const char *link)
+{
+  uint32_t hash = 2166136261u;
+  while(*link)
+  {
+    hash ^= (uint8_t)*link++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static int pwmChipLink(int chip, char *link, size_t size)
+{
+  char path[64];
+  snprintf(path, sizeof(path), PWM_SYSFS "/pwmchip%d", chip);
+  ssize_t length = readlink(path, link, size - 1);
+  if(length < 0)
+  return -1;
+  link[length] = '\0';
+  return 0;
+}
+
+static int pwmChipCount()
+{
+  DIR *dir = opendir(PWM_SYSFS);
+  if(!dir)
+  return -1;
+  int count = 0;
+  struct dirent *entry;
+  while((entry = readdir(dir)) != NULL)
+  if(strncmp(entry->d_name, "pwmchip", 7) == 0)
+  count++;
+  closedir(dir);
+  return count;
+}
+
 PWM::PWM() {
-    for (int count = 0; count < 8; count++) {
+    for (int count = 0; count < PWM_PIN_COUNT; count++) {
         pwmPin[count] = unexported;
+        period[count] = 0;
+        channelDir[count][0] = '\0';
+    }
+    if (!loadTopologyCache()) {
+        discoverChips();
+        saveTopologyCache();
     }
 }
+
 int PWM::gpioNumToPwmMap(uint8_t gpioNum)
 {
-  switch(gpioNum)
+  for(int index = 0; index < PWM_PIN_COUNT; index++)
+  if(pwmPins[index].gpio == gpioNum)
+  return index;
+  perror("Invalid PWM pin");
+  return -1;
+}
+
+// Walks /sys/class/pwm and resolves every chip to its block through the device path
+void PWM::discoverChips()
+{
+  char link[PATH_MAX];
+
+  for(int block = 0; block < PWM_BLOCK_COUNT; block++)
   {
-    case   2: return 0;
-    case 110: return 0;
-    case   3: return 1;
-    case 111: return 1;
-    case   7: return 2;
-    case  40: return 3;
-    case  80: return 3;
-    case  51: return 4;
-    case  81: return 4;
-    case  22: return 5;
-    case  70: return 5;
-    case  23: return 6;
-    case  71: return 6;
-    case  88: return 7;
-    default: perror("Invalid PWM pin"); return -1;
+    chipOfBlock[block] = -1;
+    linkHash[block] = 0;
+  }
+  chipCount = -1;
+
+  DIR *dir = opendir(PWM_SYSFS);
+  if(!dir)
+  {
+    perror("PWM chip discovery failed");
+    return;
+  }
+
+  struct dirent *entry;
+  while((entry = readdir(dir)) != NULL)
+  {
+    int chip;
+    if(sscanf(entry->d_name, "pwmchip%d", &chip) != 1)
+    continue;
+    if(pwmChipLink(chip, link, sizeof(link)) < 0)
+    continue;
+
+    // e.g. ../../devices/platform/ocp/48302000.epwmss/48302200.pwm/pwm/pwmchip4
+    int found = -1;
+    for(char *component = strtok(link, "/"); component; component = strtok(NULL, "/"))
+    {
+      char *end;
+      unsigned long address = strtoul(component, &end, 16);
+      if(end == component || *end != '.')
+      continue;
+      for(int block = 0; block < PWM_BLOCK_COUNT; block++)
+      if(pwmBlocks[block].address == address)
+      found = block;
+    }
+    if(found < 0)
+    continue;
+
+    pwmChipLink(chip, link, sizeof(link));
+    chipOfBlock[found] = chip;
+    linkHash[found] = pwmLinkHash(link);
+  }
+  closedir(dir);
+  chipCount = pwmChipCount();
+}
+
+// Cache is valid while the chip count and every chip's device link are unchanged
+bool PWM::loadTopologyCache()
+{
+  struct pwmTopologyHeader header;
+  struct pwmTopologyEntry entries[PWM_BLOCK_COUNT];
+  char link[PATH_MAX];
+
+  FILE *fd = fopen(PWM_TOPOLOGY_CACHE, "rb");
+  if(!fd)
+  return false;
+  bool valid = (fread(&header, sizeof(header), 1, fd) == 1)
+            && (header.magic == PWM_TOPOLOGY_MAGIC)
+            && (header.version == PWM_TOPOLOGY_VERSION)
+            && (header.blocks == PWM_BLOCK_COUNT)
+            && (fread(entries, sizeof(entries), 1, fd) == 1);
+  fclose(fd);
+  if(!valid || (int)header.chipCount != pwmChipCount())
+  return false;
+
+  for(int block = 0; block < PWM_BLOCK_COUNT; block++)
+  {
+    if(entries[block].chip < 0)
+    continue;
+    if(pwmChipLink(entries[block].chip, link, sizeof(link)) < 0)
+    return false;
+    if(pwmLinkHash(link) != entries[block].linkHash)
+    return false;
+  }
+
+  for(int block = 0; block < PWM_BLOCK_COUNT; block++)
+  {
+    chipOfBlock[block] = entries[block].chip;
+    linkHash[block] = entries[block].linkHash;
+  }
+  chipCount = header.chipCount;
+  return true;
+}
+
+void PWM::saveTopologyCache()
+{
+  struct pwmTopologyHeader header = { PWM_TOPOLOGY_MAGIC, PWM_TOPOLOGY_VERSION, PWM_BLOCK_COUNT, (uint32_t)chipCount };
+  struct pwmTopologyEntry entries[PWM_BLOCK_COUNT];
+
+  if(chipCount < 0)
+  return;
+  for(int block = 0; block < PWM_BLOCK_COUNT; block++)
+  {
+    entries[block].chip = chipOfBlock[block];
+    entries[block].linkHash = linkHash[block];
+  }
+
+  FILE *fd = fopen(PWM_TOPOLOGY_CACHE, "wb");
+  if(!fd)
+  {
+    perror("PWM topology cache write failed");
+    return;
+  }
+  fwrite(&header, sizeof(header), 1, fd);
+  fwrite(entries, sizeof(entries), 1, fd);
+  fclose(fd);
+}
+
+int PWM::pwmChip(uint8_t gpioPin)
+{
+  int index = gpioNumToPwmMap(gpioPin);
+  if(index < 0)
+  return -1;
+  return chipOfBlock[pwmPins[index].block];
+}
+
+int PWM::pwmChannel(uint8_t gpioPin)
+{
+  int index = gpioNumToPwmMap(gpioPin);
+  if(index < 0)
+  return -1;
+  return pwmPins[index].channel;
+}
+
+// Channel directory is pwm-<chip>:<channel> on newer kernels and pwm<channel> on older ones
+std::string PWM::channelPath(uint8_t gpioPin)
+{
+  int index = gpioNumToPwmMap(gpioPin);
+  int chip = pwmChip(gpioPin);
+  if(index < 0 || chip < 0)
+  return std::string();
+
+  if(channelDir[index][0] == '\0')
+  {
+    char path[64];
+    snprintf(path, sizeof(path), PWM_SYSFS "/pwmchip%d/pwm-%d:%d", chip, chip, pwmPins[index].channel);
+    if(access(path, F_OK) != 0)
+    {
+      snprintf(path, sizeof(path), PWM_SYSFS "/pwmchip%d/pwm%d", chip, pwmPins[index].channel);
+      if(access(path, F_OK) != 0)
+      return std::string();
+    }
+    snprintf(channelDir[index], sizeof(channelDir[index]), "%s", path);
   }
+  return std::string(channelDir[index]);
+}
+
+int PWM::writeChannel(uint8_t gpioPin, const char *attribute, uint32_t value)
+{
+  std::string path = channelPath(gpioPin);
+  if(path.empty())
+  return -1;
+  path += attribute;
+  FILE* fd = fopen(path.c_str(), "w");
+  if(!fd)
+  return -1;
+  fprintf(fd, "%u", value);
+  fclose(fd);
+  return 0;
 }
 
 int PWM::exportPin(uint8_t gpioPin) {
     char path[64];
-    snprintf(path, sizeof(path), "/sys/class/pwm/pwmchip4/export");
-    FILE* fd = fopen(path, "w");
-    if (!fd) {
+    int index = gpioNumToPwmMap(gpioPin);
+    int chip = pwmChip(gpioPin);
+    if (index < 0 || chip < 0) {
         perror("PWM export failed");
         return -1;
     }
-    fprintf(fd, "%d", gpioPin); // Use the correct variable
-    fclose(fd);
-    pwmPin[gpioNumToPwmMap(gpioPin)] = exported;
+    if (channelPath(gpioPin).empty()) {
+        snprintf(path, sizeof(path), PWM_SYSFS "/pwmchip%d/export", chip);
+        FILE* fd = fopen(path, "w");
+        if (!fd) {
+            perror("PWM export failed");
+            return -1;
+        }
+        fprintf(fd, "%d", pwmPins[index].channel);
+        fclose(fd);
+    }
+    pwmPin[index] = exported;
     return gpioPin;
 }
 
 int PWM::unexportPin(uint8_t gpioPin) {
     char path[64];
-    snprintf(path, sizeof(path), "/sys/class/pwm/pwmchip4/unexport");
+    int index = gpioNumToPwmMap(gpioPin);
+    int chip = pwmChip(gpioPin);
+    if (index < 0 || chip < 0) {
+        perror("PWM unexport failed");
+        return -1;
+    }
+    snprintf(path, sizeof(path), PWM_SYSFS "/pwmchip%d/unexport", chip);
     FILE* fd = fopen(path, "w");
     if (!fd) {
         perror("PWM unexport failed");
         return -1;
     }
-    fprintf(fd, "%d", gpioPin); // Unexport pin 4:0
+    fprintf(fd, "%d", pwmPins[index].channel);
     fclose(fd);
-    pwmPin[gpioNumToPwmMap(gpioPin)] = unexported;
+    pwmPin[index] = unexported;
+    channelDir[index][0] = '\0';
     return gpioPin;
 }
 void PWM::pwmControl(uint8_t gpioPin, Control control) {
-    char path[64];
-    snprintf(path, sizeof(path), "/sys/class/pwm/pwmchip4/pwm%d/enable", gpioPin);
-    FILE* fd = fopen(path, "w");
-    if (!fd) {
+    if (writeChannel(gpioPin, "/enable", control) < 0) {
         perror("PWM control failed");
-        return;
     }
-    fprintf(fd, "%d", control);
-    fclose(fd);
 }
 int PWM::pwmConfig(uint8_t gpioPin) {
     if (exportPin(gpioPin) >= 0) {
-        pwmPin[gpioNumToPwmMap(gpioPin)] = exported;
         setTimePeriod(gpioPin, DEFAULT_TIME_PERIOD);
         setPulseWidth(gpioPin, DEFAULT_PULSE_WIDTH);
         pwmControl(gpioPin, start);
-        gpioPins[gpioNumToPwmMap(gpioPin)] = gpioPin;
         return gpioPin;
     }
     return -1;
 }
 
 void PWM::setTimePeriodns(uint8_t gpioPin, uint32_t period_ns) {
-    char path[64];
-    snprintf(path, sizeof(path), "/sys/class/pwm/pwmchip4/pwm%d/period", gpioPin);
-    FILE* fd = fopen(path, "w");
-    if (!fd) {
+    if (writeChannel(gpioPin, "/period", period_ns) < 0) {
         perror("PWM period write failed");
         return;
     }
-    fprintf(fd, "%d", period_ns);
-    fclose(fd);
+    period[gpioNumToPwmMap(gpioPin)] = period_ns;
 }
 void PWM::setTimePeriod (uint8_t gpioPin, uint32_t period_us)
 {
@@ -374,15 +862,9 @@ void PWM::setFrequency (uint8_t gpioPin, uint32_t freq_hz)
 }
 
 void PWM::setPulseWidthns(uint8_t gpioPin, uint32_t period_ns) {
-    char path[64];
-    snprintf(path, sizeof(path), "/sys/class/pwm/pwmchip4/pwm%d/duty_cycle", gpioPin);
-    FILE* fd = fopen(path, "w");
-    if (!fd) {
+    if (writeChannel(gpioPin, "/duty_cycle", period_ns) < 0) {
         perror("PWM duty cycle write failed");
-        return;
     }
-    fprintf(fd, "%d", period_ns);
-    fclose(fd);
 }
 void PWM::setPulseWidth (uint8_t gpioPin, uint32_t period_us)
 {
@@ -396,11 +878,11 @@ void PWM::setDutyPercentage (uint8_t gpioPin, uint32_t percentage)
 }
 
 PWM::~PWM() {
-    for (int count = 0; count < 8; count++) {
+    for (int count = 0; count < PWM_PIN_COUNT; count++) {
         if (pwmPin[count] == exported) {
-            setPulseWidth(gpioPins[count], 0);
-            pwmControl(gpioPins[count], stop);
-            unexportPin(gpioPins[count]);
+            setPulseWidth(pwmPins[count].gpio, 0);
+            pwmControl(pwmPins[count].gpio, stop);
+            unexportPin(pwmPins[count].gpio);
         }
     }
 }PWM *_pwm;
@@ -413,8 +895,10 @@ PRU* pruInstance()
 
 PWM* pwmInstance()
 {
-  PWM* instance = new PWM();
-  return instance;
+  if (!_pwm) {
+    _pwm = new PWM();
+  }
+  return _pwm;
 }
 
 void analogWrite(Pin pin, uint8_t value)
@@ -461,12 +945,6 @@ void setFailsafePRU (uint32_t pulseWidth_us, uint32_t timePeriod_us)
   perror("Invalid failsafe values");
 }
 
-void* resetWatchdogPRU (void* interval)
-{
-  _pru->resetWatchdog((long)interval);
-  return (void*)0;
-}
-
 void setTimePeriod (Pin pin, uint32_t period_us)
 {
   switch(pin.selectedMode)
@@ -532,7 +1010,7 @@ void setPulseWidthns (Pin pin, uint32_t period_ns)
   switch(pin.selectedMode)
   {
     case pwm   : _pwm->setPulseWidthns(pin.pinNum, period_ns); break;
-    case pruout: perror("setPulseWidthns not available for pru"); break;
+    case pruout: _pru->setPulseWidthns(pin.pinNum, period_ns); break;
     default: perror("Invalid pwm/pru pin");
   }
 }
@@ -566,3 +1044,42 @@ uint32_t getDutyPercentage (Pin pin)
     default: perror("Invalid pru pin"); return 0;
   }
 }
+
+void setAveragingWindow (Pin pin, uint32_t periods)
+{
+  switch(pin.selectedMode)
+  {
+    case pruin : _pru->setAveragingWindow(pin.pinNum, periods); break;
+    default: perror("Invalid pru input pin");
+  }
+}
+
+uint64_t getFrequencymHz (Pin pin)
+{
+  switch(pin.selectedMode)
+  {
+    case pruin : return(_pru->getFrequencymHz(pin.pinNum)); break;
+    case pruout: return(_pru->getFrequencymHz(pin.pinNum)); break;
+    default: perror("Invalid pru pin"); return 0;
+  }
+}
+
+uint32_t getDutyppm (Pin pin)
+{
+  switch(pin.selectedMode)
+  {
+    case pruin : return(_pru->getDutyppm(pin.pinNum)); break;
+    case pruout: return(_pru->getDutyppm(pin.pinNum)); break;
+    default: perror("Invalid pru pin"); return 0;
+  }
+}
+
+uint64_t getTimePeriodns (Pin pin)
+{
+  switch(pin.selectedMode)
+  {
+    case pruin : return(_pru->getTimePeriodns(pin.pinNum)); break;
+    case pruout: return(_pru->getTimePeriodns(pin.pinNum)); break;
+    default: perror("Invalid pru pin"); return 0;
+  }
+}
@@ -22,11 +22,14 @@
 #define PWM_H
 
 #include <stdint.h>
+#include <string>
 #include "PINS.h"
 #include "CommonDefines.h"
+#include "TIMER.h"
 
 #define DEFAULT_TIME_PERIOD 2040
 #define DEFAULT_PULSE_WIDTH 0
+#define WATCHDOG_KICK_INTERVAL 100000  // us, well inside the 500 ms PRU watchdog timeout
 
 #define PRU0             0
 #define PRU1             1
@@ -38,6 +41,20 @@
 #define PRU1_CTRL_BASE   0x4a324000
 
 #define PIN_COUNT        (13 + 15)
+#define MAX_AVERAGING_WINDOW 65535  // Keeps the fixed-point scaling within 64 bits
+
+#define PRU_IRAM_SIZE      0x2000
+#define PRU0_FIRMWARE      "../PRU0.bin"
+#define PRU1_FIRMWARE      "../PRU1.bin"
+#define PRU_FIRMWARE_MAGIC 0x55525057  // "WPRU"
+#define PRU_FIRMWARE_TAG   0x1ff0      // Data RAM offset of the {crc, words} record per loaded PRU
+
+#define PWM_SYSFS            "/sys/class/pwm"
+#define PWM_TOPOLOGY_CACHE   "../PWM_TOPOLOGY.bin"
+#define PWM_TOPOLOGY_MAGIC   0x4d575057  // "WPWM"
+#define PWM_TOPOLOGY_VERSION 1
+#define PWM_BLOCK_COUNT      6           // ecap0..2, ehrpwm0..2
+#define PWM_PIN_COUNT        14
 
 class PRU {
 public:
@@ -50,6 +67,7 @@ public:
     virtual void setFrequency(uint8_t gpioPin, uint32_t freq_hz);
     virtual uint32_t getFrequency(uint8_t gpioPin);
     virtual void setPulseWidth(uint8_t gpioPin, uint32_t period_us);
+    virtual void setPulseWidthns(uint8_t gpioPin, uint32_t period_ns);
     virtual uint32_t getPulseWidth(uint8_t gpioPin);
     virtual void setDutyPercentage(uint8_t gpioPin, uint32_t percentage);
     virtual uint32_t getDutyPercentage(uint8_t gpioPin);
@@ -57,6 +75,16 @@ public:
     virtual void setFailsafePRU(uint32_t pulseWidth_us = DEFAULT_PULSE_WIDTH, uint32_t timePeriod_us = DEFAULT_TIME_PERIOD);
     virtual void resetWatchdog(long interval);
 
+    // Fixed-point input measurement, averaged by the PRU over the last full window of periods
+    virtual void setAveragingWindow(uint8_t gpioPin, uint32_t periods); // 0 reads single periods
+    virtual uint64_t getFrequencymHz(uint8_t gpioPin);
+    virtual uint32_t getDutyppm(uint8_t gpioPin);
+    virtual uint64_t getTimePeriodns(uint8_t gpioPin);
+
+    // Loads a pasm -b image, optionally prefixed by {magic, length, crc32}, into one PRU
+    // while the other keeps running. Returns 1 if loaded, 0 if already running, -1 on error
+    int loadFirmware(uint8_t pruNum, const char *path);
+
 private:
     struct pru {
         volatile uint32_t enable;
@@ -69,12 +97,29 @@ private:
         volatile uint32_t failsafe_t_on;
         volatile uint32_t failsafe_t_off;
         volatile uint32_t watchdog;
+        volatile uint32_t reserved[2];
+        struct {
+            volatile uint32_t window;
+            volatile uint32_t count;
+            volatile uint32_t on_lo, on_hi;
+            volatile uint32_t period_lo, period_hi;
+            struct {
+                volatile uint32_t count;
+                volatile uint32_t on_lo, on_hi;
+                volatile uint32_t period_lo, period_hi;
+            } result;
+            volatile uint32_t reserved;
+        } average[PIN_COUNT];
     };
 
     volatile struct pru *pru;
     uint32_t timePeriod[PIN_COUNT];
+    TimerId watchdogTimer;
 
     int gpioNumToPruMap(uint8_t num);
+    bool readAverage(uint8_t gpioPin, uint32_t &count, uint64_t &on, uint64_t &period);
+    int loadFirmware(uint8_t pruNum, const uint32_t *code, uint32_t words);
+    bool firmwareRunning(uint8_t pruNum);
     void pruInit();
 };
 
@@ -99,13 +144,26 @@ public:
     int exportPin(uint8_t gpioPin);   // Moved to public
     int unexportPin(uint8_t gpioPin); // Moved to public
 
+    // Discovered topology: sysfs chip/channel behind a header pin, -1 if unavailable
+    int pwmChip(uint8_t gpioPin);
+    int pwmChannel(uint8_t gpioPin);
+    std::string channelPath(uint8_t gpioPin); // Empty until the channel is exported
+
 private:
     typedef enum { unexported, exported } pwmStatus;
-    pwmStatus pwmPin[8];
-    uint32_t period[8];
-    uint8_t gpioPins[8];
+    pwmStatus pwmPin[PWM_PIN_COUNT];
+    uint32_t period[PWM_PIN_COUNT];
+    char channelDir[PWM_PIN_COUNT][64];
+
+    int chipOfBlock[PWM_BLOCK_COUNT];
+    uint32_t linkHash[PWM_BLOCK_COUNT];
+    int chipCount;
 
     int gpioNumToPwmMap(uint8_t gpioNum);
+    void discoverChips();
+    bool loadTopologyCache();
+    void saveTopologyCache();
+    int writeChannel(uint8_t gpioPin, const char *attribute, uint32_t value);
 };
 
 extern PWM *_pwm;
@@ -118,7 +176,6 @@ uint32_t pulseIn(Pin pin, bool polarity, uint32_t timeout = 1000000);
 
 void setPulseReadTimeout(uint32_t time_us);
 void setFailsafePRU(uint32_t pulseWidth_us = DEFAULT_PULSE_WIDTH, uint32_t timePeriod_us = DEFAULT_TIME_PERIOD);
-void* resetWatchdogPRU(void* interval);
 
 void setTimePeriod(Pin pin, uint32_t period_us);
 void setTimePeriodns(Pin pin, uint32_t period_ns);
@@ -130,6 +187,10 @@ void setPulseWidthns(Pin pin, uint32_t period_ns);
 uint32_t getPulseWidth(Pin pin);
 void setDutyPercentage(Pin pin, uint32_t percentage);
 uint32_t getDutyPercentage(Pin pin);
+void setAveragingWindow(Pin pin, uint32_t periods);
+uint64_t getFrequencymHz(Pin pin);
+uint32_t getDutyppm(Pin pin);
+uint64_t getTimePeriodns(Pin pin);
 
 #endif
 
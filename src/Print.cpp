@@ -62,31 +62,13 @@ size_t Print::print(const char c[])
 size_t Print::print(unsigned long n, int base)
 {
   if (base == 0) return write(n);
-  else return printNumber(n, base);
+  else return printNumber(n, base, false, false);
 }
 
 // Base method (signed)
 size_t Print::print(long n, int base)
 {
-  if (base == 0)
-  {
-    return write(n);
-  }
-  else if (base == 10)
-  {
-    // why must this only be in base 10?
-    if (n < 0)
-    {
-      int t = print('-');
-      n = -n;
-      return printNumber(n, 10) + t;
-    }
-    return printNumber(n, 10);
-  }
-  else
-  {
-    return printNumber(n, base);
-  }
+  return printSigned(n, base, false);
 }
 
 
@@ -111,7 +93,7 @@ size_t Print::print(int n, int base)
 
 size_t Print::print(double n, int digits)
 {
-  return printFloat(n, digits);
+  return printFloat(n, digits, false);
 }
 
 
@@ -142,75 +124,58 @@ size_t Print::print(const String &s)
 
 size_t Print::println(void)
 {
-  size_t n = print('\r');
-  n += print('\n');
-  return n;
+  return write("\r\n", 2);
 }
 
 
 size_t Print::println(const String &s)
 {
-  size_t n = print(s);
-  n += println();
-  return n;
+  return printLine(s.c_str(), s.length());
 }
 
 
 size_t Print::println(char c)
 {
-  size_t n = print(c);
-  n += println();
-  return n;
+  char buf[3] = {c, '\r', '\n'};
+  return write(buf, 3);
 }
 
 size_t Print::println(const char c[])
 {
-  size_t n = print(c);
-  n += println();
-  return n;
+  if (c == NULL) return println();
+  return printLine(c, strlen(c));
 }
 
 
 size_t Print::println(unsigned long num, int base)
 {
-  size_t n = print(num, base);
-  n += println();
-  return n;
+  if (base == 0) return println((char)num);
+  return printNumber(num, base, false, true);
 }
 
 size_t Print::println(unsigned int num, int base)
 {
-  size_t n = print(num, base);
-  n += println();
-  return n;
+  return println((unsigned long)num, base);
 }
 
 size_t Print::println(unsigned char b, int base)
 {
-  size_t n = print(b, base);
-  n += println();
-  return n;
+  return println((unsigned long)b, base);
 }
 
 size_t Print::println(long num, int base)
 {
-  size_t n = print(num, base);
-  n += println();
-  return n;
+  return printSigned(num, base, true);
 }
 
 size_t Print::println(int num, int base)
 {
-  size_t n = print(num, base);
-  n += println();
-  return n;
+  return println((long)num, base);
 }
 
 size_t Print::println(double num, int digits)
 {
-  size_t n = print(num, digits);
-  n += println();
-  return n;
+  return printFloat(num, digits, true);
 }
 
 
@@ -232,90 +197,149 @@ size_t Print::println(const __ConstantStringHelper *cs)
 
 // private methods
 
-size_t Print::printNumber(unsigned long n, uint8_t base)
+// "00" to "99", two decimal digits per lookup
+static const char digitPairs[201] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+// Formats n backwards so it ends just before end, returns the first character
+static char *formatNumber(char *end, unsigned long n, uint8_t base)
 {
-  /* BH: new version to be implemented
-    uint8_t buf[sizeof(char) * sizeof(int32_t)];
-    uint32_t i = 0;
+  char *str = end;
 
-    if (n == 0)
+  // prevent crash if called with base == 1
+  if (base < 2) base = 10;
+
+  if (base == 10)
+  {
+    while (n >= 100)
     {
-      write('0');
-      return;
+      unsigned long pair = (n % 100) * 2;
+      n /= 100;
+      *--str = digitPairs[pair + 1];
+      *--str = digitPairs[pair];
     }
-
-    while (n > 0)
+    if (n >= 10)
     {
-      buf[i++] = n % base;
-      n /= base;
+      *--str = digitPairs[n * 2 + 1];
+      *--str = digitPairs[n * 2];
     }
+    else
+    *--str = '0' + n;
+    return str;
+  }
 
-    for (; i > 0; i--)
-      write((buf[i - 1] < 10 ?
-            '0' + buf[i - 1] :
-            'A' + buf[i - 1] - 10));
-  */
-
-  char buf[8 * sizeof(long) + 1]; // Assumes 8-bit chars plus zero byte.
-  char *str = &buf[sizeof(buf) - 1];
-  
-  *str = '\0';
-  
-  // prevent crash if called with base == 1
-  if (base < 2) base = 10;
-  
   do {
     unsigned long m = n;
     n /= base;
     char c = m - base * n;
     *--str = c < 10 ? c + '0' : c + 'A' - 10;
   } while(n);
-  
-  return write(str);
+
+  return str;
 }
 
-size_t Print::printFloat(double number, uint8_t digits)
+// Each print call reaches write() once, with the line ending included for println
+size_t Print::printNumber(unsigned long n, uint8_t base, bool negative, bool newline)
 {
-  size_t n = 0;
-  
-  if (isnan(number)) return print("nan");
-  if (isinf(number)) return print("inf");
-  if (number > 4294967040.0) return print ("ovf");  // constant determined empirically
-  if (number <-4294967040.0) return print ("ovf");  // constant determined empirically
-  
-  // Handle negative numbers
-  if (number < 0.0)
+  char buf[8 * sizeof(long) + 3]; // Assumes 8-bit chars plus sign and line ending.
+  char *end = &buf[sizeof(buf)];
+
+  if (newline)
   {
-    n += print('-');
-    number = -number;
+    *--end = '\n';
+    *--end = '\r';
   }
-  
-  // Round correctly so that print(1.999, 2) prints as "2.00"
-  double rounding = 0.5;
-  for (uint8_t i=0; i<digits; ++i)
-  rounding /= 10.0;
-  
-  number += rounding;
-  
-  // Extract the integer part of the number and print it
-  unsigned long int_part = (unsigned long)number;
-  double remainder = number - (double)int_part;
-  n += print(int_part);
-  
-  // Print the decimal point, but only if there are digits beyond
-  if (digits > 0) {
-    n += print(".");
-  }
-  
-  // Extract digits from the remainder one at a time
-  while (digits-- > 0)
+  char *str = formatNumber(end, n, base);
+  if (negative) *--str = '-';
+  if (newline) end += 2;
+
+  return write(str, end - str);
+}
+
+size_t Print::printSigned(long n, int base, bool newline)
+{
+  if (base == 0)
+  return newline ? println((char)n) : write(n);
+
+  // why must this only be in base 10?
+  if (base == 10 && n < 0)
+  return printNumber(0UL - (unsigned long)n, 10, true, newline);
+
+  return printNumber(n, base, false, newline);
+}
+
+size_t Print::printLine(const char *str, size_t length)
+{
+  char buf[64];
+
+  // Short lines go out as one write, longer ones are not worth copying
+  if (length + 2 > sizeof(buf))
   {
-    remainder *= 10.0;
-    int toPrint = int(remainder);
-    n += print(toPrint);
-    remainder -= toPrint;
+    size_t n = write(str, length);
+    return n + println();
   }
-  
-  return n;
+  memcpy(buf, str, length);
+  buf[length] = '\r';
+  buf[length + 1] = '\n';
+  return write(buf, length + 2);
 }
 
+size_t Print::printFloat(double number, uint8_t digits, bool newline)
+{
+  char buf[8 * sizeof(long) + 256 + 4]; // integer part, '.', up to 255 digits, sign and line ending
+  char digit[4];
+  char *str = buf;
+
+  if (isnan(number)) str = stpcpy(str, "nan");
+  else if (isinf(number)) str = stpcpy(str, "inf");
+  else if (number > 4294967040.0) str = stpcpy(str, "ovf");  // constant determined empirically
+  else if (number <-4294967040.0) str = stpcpy(str, "ovf");  // constant determined empirically
+  else
+  {
+    // Handle negative numbers
+    if (number < 0.0)
+    {
+      *str++ = '-';
+      number = -number;
+    }
+
+    // Round correctly so that print(1.999, 2) prints as "2.00"
+    double rounding = 0.5;
+    for (uint8_t i=0; i<digits; ++i)
+    rounding /= 10.0;
+
+    number += rounding;
+
+    // Extract the integer part of the number and print it
+    unsigned long int_part = (unsigned long)number;
+    double remainder = number - (double)int_part;
+    char *end = &buf[8 * sizeof(long) + 1];
+    char *first = formatNumber(end, int_part, 10);
+    memmove(str, first, end - first);
+    str += end - first;
+
+    // Print the decimal point, but only if there are digits beyond
+    if (digits > 0) {
+      *str++ = '.';
+    }
+
+    // Extract digits from the remainder one at a time
+    while (digits-- > 0)
+    {
+      remainder *= 10.0;
+      int toPrint = int(remainder);
+      char *d = formatNumber(&digit[sizeof(digit)], toPrint, 10);
+      while (d < &digit[sizeof(digit)]) *str++ = *d++;
+      remainder -= toPrint;
+    }
+  }
+
+  if (newline)
+  {
+    *str++ = '\r';
+    *str++ = '\n';
+  }
+  return write(buf, str - buf);
+}
@@ -93,8 +93,10 @@ class Print
 
   private:
     int write_error;
-    size_t printNumber(unsigned long, uint8_t);
-    size_t printFloat(double, uint8_t);
+    size_t printNumber(unsigned long, uint8_t, bool negative, bool newline);
+    size_t printSigned(long, int, bool newline);
+    size_t printFloat(double, uint8_t, bool newline);
+    size_t printLine(const char *, size_t);
   protected:
     void setWriteError(int err = 1) { write_error = err; }
 };
@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
@@ -44,6 +45,11 @@ SPIClass::SPIClass(int deviceID)
   }
 }
 
+SPIClass::SPIClass(const char *devicePath)
+{
+  snprintf(this -> device, sizeof(this -> device), "%s", devicePath);
+}
+
 void SPIClass::begin()
 {
   SPISettings defaultSetting;
@@ -63,39 +69,70 @@ void SPIClass::begin()
 
 uint8_t SPIClass::transfer(uint8_t data)
 {
-  this -> spiTransfer(&data, 1);
+  this -> spiTransfer(&data, &data, 1);
   return data;
 }
 
 uint16_t SPIClass::transfer16(uint16_t data)
 {
-  union
-  {
-    uint16_t val;
-    struct
-    {
-      uint8_t lsb;
-      uint8_t msb;
-    };
-  } value;
-  value.val = data;
+  uint8_t buf[2];
   if(this -> bit_order == MSBFIRST)
   {
-   this -> spiTransfer(&(value.msb), 1);
-   this -> spiTransfer(&(value.lsb), 1);
+    buf[0] = data >> 8;
+    buf[1] = data & 0xff;
+    this -> spiTransfer(buf, buf, 2);
+    data = (buf[0] << 8) | buf[1];
   }
   else
   {
-   this -> spiTransfer(&(value.lsb), 1);
-   this -> spiTransfer(&(value.msb), 1);
+    buf[0] = data & 0xff;
+    buf[1] = data >> 8;
+    this -> spiTransfer(buf, buf, 2);
+    data = (buf[1] << 8) | buf[0];
   }
-  data = value.val;
   return data;
 }
 
 void SPIClass::transfer(void *buf, size_t count)
 {
-  this -> spiTransfer((unsigned char*)buf, count);
+  this -> spiTransfer((unsigned char*)buf, (unsigned char*)buf, count);
+}
+
+int SPIClass::transfer(const void *txBuf, void *rxBuf, size_t count)
+{
+  return this -> spiTransfer((const unsigned char*)txBuf, (unsigned char*)rxBuf, count);
+}
+
+int SPIClass::transfer(const SPISegment *segments, size_t count)
+{
+  // Chip select is held across the whole message unless a segment asks to drop it
+  while(count > 0)
+  {
+    size_t chunk = count < SPI_MAX_SEGMENTS ? count : SPI_MAX_SEGMENTS;
+    if(messages.size() < chunk)
+    messages.resize(chunk);
+    struct spi_ioc_transfer *spiDevice = messages.data();
+    memset(spiDevice, 0, chunk * sizeof(struct spi_ioc_transfer));
+    for(size_t index = 0; index < chunk; index++)
+    {
+      spiDevice[index].tx_buf = (unsigned long) segments[index].tx;
+      spiDevice[index].rx_buf = (unsigned long) segments[index].rx;
+      spiDevice[index].len = segments[index].length;
+      spiDevice[index].cs_change = segments[index].csChange;
+      spiDevice[index].delay_usecs = segments[index].delay_usecs;
+      spiDevice[index].bits_per_word = bitsPerWord;
+      spiDevice[index].speed_hz = segments[index].speed_hz ? segments[index].speed_hz : speed;
+    }
+
+    if(ioctl(this -> fd, SPI_IOC_MESSAGE(chunk), spiDevice) < 0)
+    {
+      perror("SPI transfer failed");
+      return -1;
+    }
+    segments += chunk;
+    count -= chunk;
+  }
+  return 0;
 }
 
 void SPIClass::end()
@@ -112,22 +149,17 @@ void SPIClass::setBitOrder(uint8_t bitOrder)
 
 void SPIClass::setDataMode(uint8_t dataMode)
 {
+  uint8_t mode;
   switch(dataMode)
   {
-    case SPI_MODE0 : if(ioctl(this -> fd, SPI_IOC_WR_MODE, SPI_MODE_0) < 0)
-                     perror("SPI set data mode failed");
-                     break;
-    case SPI_MODE1 : if(ioctl(this -> fd, SPI_IOC_WR_MODE, SPI_MODE_1) < 0)
-                     perror("SPI set data mode failed");
-                     break;
-    case SPI_MODE2 : if(ioctl(this -> fd, SPI_IOC_WR_MODE, SPI_MODE_2) < 0)
-                     perror("SPI set data mode failed");
-                     break;
-    case SPI_MODE3 : if(ioctl(this -> fd, SPI_IOC_WR_MODE, SPI_MODE_3) < 0)
-                     perror("SPI set data mode failed");
-                     break;
-    default : perror("Invalid data mode");
+    case SPI_MODE0 : mode = SPI_MODE_0; break;
+    case SPI_MODE1 : mode = SPI_MODE_1; break;
+    case SPI_MODE2 : mode = SPI_MODE_2; break;
+    case SPI_MODE3 : mode = SPI_MODE_3; break;
+    default : perror("Invalid data mode"); return;
   }
+  if(ioctl(this -> fd, SPI_IOC_WR_MODE, &mode) < 0)
+  perror("SPI set data mode failed");
 }
 
 void SPIClass::setClockDivider(uint8_t clockDiv)
@@ -145,11 +177,12 @@ void SPIClass::setClock(uint32_t clock_hz)
   this -> speed = clock_hz;
 }
 
-int SPIClass::spiTransfer(unsigned char *data, int length)
+int SPIClass::spiTransfer(const unsigned char *txBuf, unsigned char *rxBuf, int length)
 {
   struct spi_ioc_transfer spiDevice;
-  spiDevice.tx_buf = (unsigned long) &data;
-  spiDevice.rx_buf = (unsigned long) &data;
+  memset(&spiDevice, 0, sizeof(spiDevice));
+  spiDevice.tx_buf = (unsigned long) txBuf;
+  spiDevice.rx_buf = (unsigned long) rxBuf;
   spiDevice.len = length;
   spiDevice.delay_usecs = delayUsecs;
   spiDevice.bits_per_word = bitsPerWord;
@@ -22,6 +22,8 @@
 #define SPI_H
 
 #include <stdint.h>
+#include <vector>
+#include <linux/spi/spidev.h>
 #include "PINS.h"
 
 #define MSBFIRST 0
@@ -49,9 +51,12 @@ class SPISettings
       this -> bitOrder = bitOrder;
       this -> dataMode = dataMode;
     }
-    SPISettings()
+    SPISettings() : SPISettings(4000000, MSBFIRST, SPI_MODE0)
     {
-      SPISettings(4000000, MSBFIRST, SPI_MODE0);
+    }
+    bool operator==(const SPISettings &other) const
+    {
+      return clock == other.clock && bitOrder == other.bitOrder && dataMode == other.dataMode;
     }
   uint32_t clock;
   uint8_t bitOrder;
@@ -59,10 +64,24 @@ class SPISettings
   friend class SPI;
 };
 
+// One segment of a chained transaction, tx or rx may be NULL for half duplex
+struct SPISegment
+{
+  const void *tx;
+  void *rx;
+  uint32_t length;
+  bool csChange;        // Deselect chip select after this segment
+  uint16_t delay_usecs; // Delay after this segment
+  uint32_t speed_hz;    // 0 uses the current clock
+};
+
+#define SPI_MAX_SEGMENTS 511 // Largest SPI_IOC_MESSAGE(n) that fits the ioctl size field
+
 class SPIClass
 {
   public:
     SPIClass(int deviceID);
+    SPIClass(const char *devicePath);     // Any spidev node, e.g. on kernels that number buses differently
 
     void begin();
     inline void beginTransaction(SPISettings settings)
@@ -74,6 +93,8 @@ class SPIClass
     uint8_t transfer(uint8_t data);
     uint16_t transfer16(uint16_t data);
     void transfer(void *buf, size_t count);
+    int transfer(const void *txBuf, void *rxBuf, size_t count);
+    int transfer(const SPISegment *segments, size_t count); // All segments in one ioctl
     inline void endTransaction(void)
     {
     }
@@ -86,11 +107,12 @@ class SPIClass
 
   private:
     int fd;
-    char device[16];
+    char device[64];
     uint32_t speed;
     uint8_t bit_order;
+    std::vector<struct spi_ioc_transfer> messages;  // Reused by segment transfers, grows to the largest chunk
 
-    int spiTransfer(unsigned char *data, int length);
+    int spiTransfer(const unsigned char *txBuf, unsigned char *rxBuf, int length);
 };
 
 #if (P9_17_MODE == spi) || (P9_18_MODE == spi) || (P9_21_MODE == spi) || (P9_22_MODE == spi)
@@ -0,0 +1,106 @@
+/*
+    This file is a part of the wiringBone library
+    Asynchronous SPI transaction queue with one worker thread per bus
+*/
+
+#include "SPIQueue.h"
+
+SPIQueue::SPIQueue(SPIClass &bus)
+    : bus(bus),
+      pending(nullptr),
+      settingsApplied(false),
+      exitFlag(false) {
+    worker = std::thread(&SPIQueue::run, this);
+}
+
+SPIQueue::~SPIQueue() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        exitFlag = true;
+    }
+    wakeCv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+std::future<int> SPIQueue::submit(const SPISettings &settings, const SPISegment *segments, size_t count) {
+    Request *request = new Request{settings, std::vector<SPISegment>(segments, segments + count), {}, nullptr, nullptr};
+    std::future<int> result = request->result.get_future();
+    push(request);
+    return result;
+}
+
+void SPIQueue::submit(const SPISettings &settings, const SPISegment *segments, size_t count, Completion done) {
+    push(new Request{settings, std::vector<SPISegment>(segments, segments + count), {}, done, nullptr});
+}
+
+void SPIQueue::push(Request *request) {
+    Request *head = pending.load(std::memory_order_relaxed);
+    do {
+        request->next = head;
+    } while (!pending.compare_exchange_weak(head, request, std::memory_order_release, std::memory_order_relaxed));
+
+    // Only a push onto an empty queue can find the worker asleep
+    if (head == nullptr) {
+        { std::lock_guard<std::mutex> lock(wakeMutex); }
+        wakeCv.notify_one();
+    }
+}
+
+void SPIQueue::complete(Request *request, int status) {
+    if (request->done) {
+        request->done(status);
+    } else {
+        request->result.set_value(status);
+    }
+    delete request;
+}
+
+void SPIQueue::run() {
+    std::vector<Request*> batch;
+    std::vector<SPISegment> segments;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCv.wait(lock, [this] { return exitFlag || pending.load(std::memory_order_relaxed) != nullptr; });
+            if (exitFlag && pending.load(std::memory_order_relaxed) == nullptr) {
+                return;
+            }
+        }
+
+        // Take everything submitted so far and restore submission order
+        batch.clear();
+        for (Request *request = pending.exchange(nullptr, std::memory_order_acquire); request; request = request->next) {
+            batch.push_back(request);
+        }
+
+        size_t index = batch.size();
+        while (index > 0) {
+            // Group adjacent transactions with identical settings into one message
+            SPISettings settings = batch[index - 1]->settings;
+            size_t first = index;
+            segments.clear();
+            while (index > 0 && batch[index - 1]->settings == settings &&
+                   (segments.empty() || segments.size() + batch[index - 1]->segments.size() <= SPI_MAX_SEGMENTS)) {
+                Request *request = batch[--index];
+                if (!segments.empty()) {
+                    segments.back().csChange = true;    // Deselect between transactions
+                }
+                segments.insert(segments.end(), request->segments.begin(), request->segments.end());
+            }
+
+            if (!settingsApplied || !(applied == settings)) {
+                bus.beginTransaction(settings);
+                applied = settings;
+                settingsApplied = true;
+            }
+
+            int status = segments.empty() ? 0 : bus.transfer(segments.data(), segments.size());
+            for (size_t done = first; done > index; done--) {
+                complete(batch[done - 1], status);
+            }
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/*
+    This file is a part of the wiringBone library
+    Asynchronous SPI transaction queue with one worker thread per bus
+*/
+
+#ifndef SPIQUEUE_H
+#define SPIQUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include "SPI.h"
+
+class SPIQueue {
+public:
+    typedef std::function<void(int)> Completion;    // Receives 0 on success, -1 on failure
+
+    explicit SPIQueue(SPIClass &bus);
+    ~SPIQueue();
+
+    // Segment buffers are used in place and must stay valid until the transaction completes
+    std::future<int> submit(const SPISettings &settings, const SPISegment *segments, size_t count);
+    void submit(const SPISettings &settings, const SPISegment *segments, size_t count, Completion done);
+
+private:
+    struct Request {
+        SPISettings settings;
+        std::vector<SPISegment> segments;
+        std::promise<int> result;
+        Completion done;
+        Request *next;
+    };
+
+    SPIClass &bus;
+    std::atomic<Request*> pending;          // Lock-free LIFO of submissions, drained in one exchange
+    SPISettings applied;
+    bool settingsApplied;
+    bool exitFlag;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;
+    std::thread worker;
+
+    void push(Request *request);
+    void run();
+    void complete(Request *request, int status);
+};
+
+#endif
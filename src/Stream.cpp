@@ -21,6 +21,8 @@
 */
 
 
+#include <charconv>
+#include <type_traits>
 #include "Wiring.h"
 #include "Stream.h"
 
@@ -31,10 +33,13 @@
 int Stream::timedRead()
 {
   int c;
+  unsigned long elapsed;
   _startMillis = millis();
   do {
     c = read();
     if (c >= 0) return c;
+    elapsed = millis() - _startMillis;
+    if (elapsed < _timeout) waitReadable(_timeout - elapsed);
   } while(millis() - _startMillis < _timeout);
   return -1;     // -1 indicates timeout
 }
@@ -43,10 +48,13 @@ int Stream::timedRead()
 int Stream::timedPeek()
 {
   int c;
+  unsigned long elapsed;
   _startMillis = millis();
   do {
     c = peek();
     if (c >= 0) return c;
+    elapsed = millis() - _startMillis;
+    if (elapsed < _timeout) waitReadable(_timeout - elapsed);
   } while(millis() - _startMillis < _timeout);
   return -1;     // -1 indicates timeout
 }
@@ -147,6 +155,9 @@ long Stream::parseInt(char skipChar)
   // ignore non numeric leading characters
   if(c < 0)
   return 0; // zero returned if timeout
+
+  if(skipChar == NO_SKIP_CHAR && parseWindow(value))
+  return value;
   
   do{
     if(c == skipChar)
@@ -179,12 +190,16 @@ float Stream::parseFloat(char skipChar){
   boolean isFraction = false;
   long value = 0;
   char c;
-  float fraction = 1.0;
+  double scale = 1.0;
+  float result;
   
   c = peekNextDigit();
   // ignore non numeric leading characters
   if(c < 0)
   return 0; // zero returned if timeout
+
+  if(skipChar == NO_SKIP_CHAR && parseWindow(result))
+  return result;
   
   do{
     if(c == skipChar)
@@ -196,7 +211,7 @@ float Stream::parseFloat(char skipChar){
     else if(c >= '0' && c <= '9')  {      // is c a digit?
       value = value * 10 + c - '0';
       if(isFraction)
-      fraction *= 0.1;
+      scale *= 10.0;
     }
     read();  // consume the character we got with peek
     c = timedPeek();
@@ -205,12 +220,109 @@ float Stream::parseFloat(char skipChar){
   
   if(isNegative)
   value = -value;
+  // one division keeps the result correctly rounded, unlike repeated multiplies by 0.1
   if(isFraction)
-  return value * fraction;
+  return value / scale;
   else
   return value;
 }
 
+// parses the number at the front of the buffered window with from_chars
+// false if the stream has no window or the number may continue past its end,
+// the caller then falls back to reading character by character
+template<typename T>
+bool Stream::parseWindow(T &value)
+{
+  const char *window;
+  size_t length = peekWindow(window);
+  if(length == 0)
+  return false;
+
+  std::from_chars_result parsed;
+  if constexpr (std::is_floating_point<T>::value)
+  parsed = std::from_chars(window, window + length, value, std::chars_format::fixed);
+  else
+  parsed = std::from_chars(window, window + length, value);
+  if(parsed.ec != std::errc() || parsed.ptr == window + length)
+  return false;
+
+  consume(parsed.ptr - window);
+  return true;
+}
+
+// fields are separated by commas, spaces or tabs and the record ends at a newline
+template<typename T>
+size_t Stream::parseFields(T *values, size_t count)
+{
+  size_t index = 0;
+  _startMillis = millis();
+
+  while(index < count)
+  {
+    const char *window;
+    size_t length = peekWindow(window);
+    if(length == 0)
+    {
+      int c = peek();
+      if(c < 0)
+      {
+        unsigned long elapsed = millis() - _startMillis;
+        if(elapsed >= _timeout || !waitReadable(_timeout - elapsed))
+        break;
+        continue;
+      }
+      // no window to parse in place, take the separator or number through the slow path
+      if(c == ',' || c == ' ' || c == '\t' || c == '\r')
+      read();
+      else if(c == '\n')
+      {
+        read();
+        break;
+      }
+      else if((c >= '0' && c <= '9') || c == '-' || (c == '.' && std::is_floating_point<T>::value))
+      values[index++] = std::is_floating_point<T>::value ? (T)parseFloat() : (T)parseInt();
+      else
+      read();
+      continue;
+    }
+
+    size_t skip = 0;
+    while(skip < length && (window[skip] == ',' || window[skip] == ' ' || window[skip] == '\t' || window[skip] == '\r'))
+    skip++;
+    if(skip > 0)
+    {
+      consume(skip);
+      continue;
+    }
+    if(window[0] == '\n')
+    {
+      consume(1);
+      break;
+    }
+
+    T value;
+    if(parseWindow(value))
+    values[index++] = value;
+    else if((window[0] >= '0' && window[0] <= '9') || window[0] == '-' || (window[0] == '.' && std::is_floating_point<T>::value))
+    // the number reaches the end of the window, finish it character by character
+    values[index++] = std::is_floating_point<T>::value ? (T)parseFloat() : (T)parseInt();
+    else
+    consume(1); // not part of a number
+    _startMillis = millis();
+  }
+  return index;
+}
+
+size_t Stream::parseRecord(long *values, size_t count)
+{
+  return parseFields(values, count);
+}
+
+size_t Stream::parseRecord(float *values, size_t count)
+{
+  return parseFields(values, count);
+}
+
 // read characters from stream into buffer
 // terminates if length characters have been read, or timeout (see setTimeout)
 // returns the number of characters placed in the buffer
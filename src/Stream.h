@@ -42,6 +42,15 @@ class Stream : public Print
     virtual int peek() = 0;
     virtual int read() = 0;
     virtual void flush() = 0;
+
+    // Sleeps until data can be read or timeout milliseconds pass, true if data is ready.
+    // Streams that cannot block report availability and timed reads poll instead
+    virtual bool waitReadable(unsigned long timeout) { return available() > 0; }
+
+    // Bytes already buffered that can be parsed in place, 0 if the stream keeps no such buffer.
+    // consume() drops bytes from the front of that window
+    virtual size_t peekWindow(const char *&window) { return 0; }
+    virtual void consume(size_t count) { while (count--) read(); }
   
     Stream() {_timeout=1000;}
   // parsing methods
@@ -64,8 +73,11 @@ class Stream : public Print
     // integer is terminated by the first character that is not a digit.
   
     float parseFloat();               // float version of parseInt
+
+    size_t parseRecord(long *values, size_t count);  // comma/space separated fields up to a newline
+    size_t parseRecord(float *values, size_t count);  // returns the number of fields stored
   
-    size_t readBytes( char *buffer, size_t length); // read chars from stream into buffer
+    virtual size_t readBytes( char *buffer, size_t length); // read chars from stream into buffer
     // terminates if length characters have been read or timeout (see setTimeout)
     // returns the number of characters placed in the buffer (0 means no valid data found)
   
@@ -83,6 +95,10 @@ class Stream : public Print
     // this allows format characters (typically commas) in values to be ignored
   
     float parseFloat(char skipChar);  // as above but the given skipChar is ignored
+
+  private:
+    template<typename T> bool parseWindow(T &value);  // number at the front of the window
+    template<typename T> size_t parseFields(T *values, size_t count);
 };
 
 #endif
@@ -0,0 +1,203 @@
+/*
+    This file is a part of the wiringBone library
+    Cooperative coroutine tasks on a single event loop thread
+*/
+
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <iostream>
+#include <exception>
+#include "TASK.h"
+#include "TIMER.h"
+#include "WConstants.h"
+
+void Task::promise_type::unhandled_exception() {
+    try {
+        throw;
+    } catch (const std::exception &e) {
+        std::cerr << "Task ended by exception: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Task ended by unknown exception" << std::endl;
+    }
+}
+
+EventLoop::EventLoop()
+    : epollFd(-1),
+      wakeFd(-1),
+      sleeping(false),
+      stopFlag(false) {
+    if ((epollFd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        perror("Event loop epoll failed");
+        return;
+    }
+    if ((wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0) {
+        perror("Event loop eventfd failed");
+        return;
+    }
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0) {
+        perror("Event loop wake registration failed");
+    }
+}
+
+EventLoop::~EventLoop() {
+    if (wakeFd >= 0) {
+        close(wakeFd);
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+}
+
+// Only a loop blocked in epoll_wait needs the eventfd; a busy loop finds the work on its next pass
+void EventLoop::wake(void) {
+    if (sleeping) {
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            perror("Event loop wake failed");
+        }
+    }
+}
+
+void EventLoop::post(std::coroutine_handle<> handle) {
+    post([handle] { handle.resume(); });
+}
+
+void EventLoop::post(std::function<void()> work) {
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        ready.push_back(std::move(work));
+    }
+    wake();
+}
+
+int EventLoop::watch(int fd, uint32_t events, std::coroutine_handle<> handle) {
+    struct epoll_event event = {};
+    event.events = events | EPOLLONESHOT;
+    event.data.ptr = handle.address();
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        perror("Event loop watch failed");
+        return -1;
+    }
+    return 0;
+}
+
+void EventLoop::stop() {
+    stopFlag = true;
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        perror("Event loop stop failed");
+    }
+}
+
+void EventLoop::run() {
+    std::vector<std::function<void()>> batch;
+    struct epoll_event events[16];
+
+    stopFlag = false;
+    while (!stopFlag) {
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            batch.swap(ready);
+        }
+        for (std::function<void()> &work : batch) {
+            work();
+        }
+        if (!batch.empty()) {
+            batch.clear();
+            continue;
+        }
+
+        // Posters check the flag after queueing, so either they see it or this sees their work
+        sleeping = true;
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            if (!ready.empty()) {
+                sleeping = false;
+                continue;
+            }
+        }
+        int count = epoll_wait(epollFd, events, 16, -1);
+        sleeping = false;
+        if (count < 0) {
+            if (errno != EINTR) {
+                perror("Event loop wait failed");
+            }
+            continue;
+        }
+
+        for (int index = 0; index < count; index++) {
+            if (events[index].data.ptr == NULL) {
+                uint64_t value;
+                if (read(wakeFd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+                    perror("Event loop wake read failed");
+                }
+                continue;
+            }
+            std::coroutine_handle<>::from_address(events[index].data.ptr).resume();
+        }
+    }
+}
+
+EventLoop &eventLoop() {
+    static EventLoop loop;
+    return loop;
+}
+
+void DelayAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    if (duration_ms == 0) {
+        eventLoop().post(handle);
+        return;
+    }
+    timerWheel()->schedule(duration_ms, [handle] { eventLoop().post(handle); });
+}
+
+void EdgeAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    static const char *edges[] = {"rising", "falling", "both"};
+    char path[64], value[4];
+    FILE *edgeFile;
+
+    sprintf(path, "/sys/class/gpio/gpio%d/edge", pin.pinNum);
+    if ((edgeFile = fopen(path, "w")) == NULL) {
+        perror("Pin edge setup failed");
+        eventLoop().post(handle);
+        return;
+    }
+    fputs(edges[edge], edgeFile);
+    fclose(edgeFile);
+
+    sprintf(path, "/sys/class/gpio/gpio%d/value", pin.pinNum);
+    if ((fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC)) < 0) {
+        perror("Pin edge open failed");
+        eventLoop().post(handle);
+        return;
+    }
+    // sysfs reports an edge until the value file has been read once
+    if (pread(fd, value, sizeof(value), 0) < 0 || eventLoop().watch(fd, EPOLLPRI | EPOLLERR, handle) < 0) {
+        close(fd);
+        fd = -1;
+        eventLoop().post(handle);
+    }
+}
+
+int EdgeAwaiter::await_resume() {
+    char value[4];
+    int level = -1;
+
+    if (fd < 0) {
+        return -1;
+    }
+    // Closing the descriptor also removes it from the epoll set
+    if (pread(fd, value, sizeof(value), 0) > 0) {
+        level = value[0] == '1' ? HIGH : LOW;
+    }
+    close(fd);
+    fd = -1;
+    return level;
+}
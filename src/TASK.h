@@ -0,0 +1,107 @@
+/*
+    This file is a part of the wiringBone library
+    Cooperative coroutine tasks on a single event loop thread
+*/
+
+#ifndef TASK_H
+#define TASK_H
+
+#include <stdint.h>
+#include <coroutine>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include "PINS.h"
+
+// Calling a function returning Task starts it on the event loop; the frame frees itself when it returns
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return {}; }
+        auto initial_suspend() noexcept;
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();
+    };
+};
+
+class EventLoop {
+public:
+    EventLoop();
+    ~EventLoop();
+
+    void run();                 // Resumes tasks on the calling thread until stop()
+    void stop();                // Safe from any thread
+
+    // Both are safe from any thread and resume the handle on the loop thread
+    void post(std::coroutine_handle<> handle);
+    void post(std::function<void()> work);
+
+    // Resumes the handle once fd reports one of events; loop thread only
+    int watch(int fd, uint32_t events, std::coroutine_handle<> handle);
+
+private:
+    int epollFd;
+    int wakeFd;
+    std::mutex readyMutex;
+    std::vector<std::function<void()>> ready;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> stopFlag;
+
+    void wake(void);
+};
+
+EventLoop &eventLoop();
+
+inline auto Task::promise_type::initial_suspend() noexcept {
+    struct Schedule {
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) noexcept { eventLoop().post(handle); }
+        void await_resume() noexcept {}
+    };
+    return Schedule{};
+}
+
+// co_await delayMs(n) resumes after at least n ms; delayMs(0) lets other ready tasks run
+struct DelayAwaiter {
+    uint32_t duration_ms;
+
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() noexcept {}
+};
+
+inline DelayAwaiter delayMs(uint32_t duration_ms) {
+    return DelayAwaiter{duration_ms};
+}
+
+typedef enum { edgeRising, edgeFalling, edgeBoth } PinEdge;
+
+// co_await pinEdge(pin) waits for an edge on an exported gpio input, then yields the new level (-1 on error)
+struct EdgeAwaiter {
+    Pin pin;
+    PinEdge edge;
+    int fd;
+
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    int await_resume();
+};
+
+inline EdgeAwaiter pinEdge(Pin pin, PinEdge edge = edgeBoth) {
+    return EdgeAwaiter{pin, edge, -1};
+}
+
+// co_await serial.readable() resumes once bytes are waiting or the port has closed
+template <typename Source>
+struct ReadableAwaiter {
+    Source &source;
+
+    bool await_ready() { return source.available() > 0; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        source.onReadable([handle] { eventLoop().post(handle); });
+    }
+    void await_resume() {}
+};
+
+#endif
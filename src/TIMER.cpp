@@ -0,0 +1,378 @@
+/*
+    This file is a part of the wiringBone library
+    Hashed hierarchical timer wheel driven by one timerfd
+*/
+
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <vector>
+#include "TIMER.h"
+
+static uint64_t monotonicNanos()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static uint64_t rotateRight(uint64_t bits, unsigned count)
+{
+  count &= 63;
+  return count ? (bits >> count) | (bits << (64 - count)) : bits;
+}
+
+TimerWheel::TimerWheel()
+    : freeList(none),
+      currentTick(0),
+      startNanos(monotonicNanos()),
+      armedTick(0),
+      liveCount(0),
+      timerFd(-1),
+      stopFd(-1) {
+    for (uint32_t &head : heads) {
+        head = none;
+    }
+    for (uint64_t &bits : occupied) {
+        bits = 0;
+    }
+
+    if ((timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK)) < 0) {
+        perror("Timer wheel timerfd failed");
+        return;
+    }
+    if ((stopFd = eventfd(0, EFD_CLOEXEC)) < 0) {
+        perror("Timer wheel eventfd failed");
+        return;
+    }
+    worker = std::thread(&TimerWheel::run, this);
+}
+
+TimerWheel::~TimerWheel() {
+    if (worker.joinable()) {
+        uint64_t one = 1;
+        if (write(stopFd, &one, sizeof(one)) < 0) {
+            perror("Timer wheel stop failed");
+        }
+        worker.join();
+    }
+    if (stopFd >= 0) {
+        close(stopFd);
+    }
+    if (timerFd >= 0) {
+        close(timerFd);
+    }
+}
+
+uint64_t TimerWheel::nowTick(void) {
+    return (monotonicNanos() - startNanos) / TIMER_TICK_NS;
+}
+
+TimerId TimerWheel::schedule(uint32_t delay_ms, Callback callback) {
+    return add(delay_ms * 1000000ULL, 0, callback);
+}
+
+TimerId TimerWheel::schedulePeriodic(uint32_t period_ms, Callback callback, uint32_t firstDelay_ms) {
+    uint64_t period = period_ms * 1000000ULL / TIMER_TICK_NS;
+    if (period == 0) {
+        period = 1;
+    }
+    return add((firstDelay_ms ? firstDelay_ms : period_ms) * 1000000ULL, period, callback);
+}
+
+TimerId TimerWheel::add(uint64_t delayNanos, uint32_t period, Callback callback) {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+
+    // An idle wheel stops ticking; catch up so the delay counts from now
+    uint64_t elapsed = monotonicNanos() - startNanos;
+    if (liveCount == 0 && elapsed / TIMER_TICK_NS > currentTick) {
+        currentTick = elapsed / TIMER_TICK_NS;
+    }
+
+    uint32_t index;
+    if (freeList != none) {
+        index = freeList;
+        freeList = timers[index].next;
+    }
+    else {
+        index = timers.size();
+        timers.push_back(Timer{});
+        timers[index].generation = 1;
+    }
+
+    Timer &timer = timers[index];
+    // Rounded up to a tick boundary so a timer never fires before its delay
+    timer.expiry = (elapsed + delayNanos + TIMER_TICK_NS - 1) / TIMER_TICK_NS;
+    timer.period = period;
+    timer.firing = false;
+    timer.cancelled = false;
+    timer.callback = std::move(callback);
+    link(index);
+    liveCount++;
+
+    arm();
+    return (uint64_t)timer.generation << 32 | index;
+}
+
+TimerWheel::Timer *TimerWheel::lookup(TimerId id, uint32_t &index) {
+    index = (uint32_t)id;
+    if (index >= timers.size() || timers[index].generation != (uint32_t)(id >> 32)) {
+        return NULL;
+    }
+    return &timers[index];
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+    return cancelLocked(id);
+}
+
+bool TimerWheel::cancelAndWait(TimerId id) {
+    std::unique_lock<std::mutex> lock(wheelMutex);
+    bool cancelled = cancelLocked(id);
+
+    if (std::this_thread::get_id() != worker.get_id()) {
+        uint32_t index;
+        // Release bumps the generation, so a finished callback stops matching the id
+        firedCv.wait(lock, [&] {
+            Timer *timer = lookup(id, index);
+            return timer == NULL || !timer->firing;
+        });
+    }
+    return cancelled;
+}
+
+bool TimerWheel::cancelLocked(TimerId id) {
+    uint32_t index;
+    Timer *timer = lookup(id, index);
+    if (timer == NULL || timer->cancelled || (!timer->queued && !timer->firing)) {
+        return false;
+    }
+
+    liveCount--;
+    if (timer->firing) {
+        // The wheel thread releases it once the callback returns
+        timer->cancelled = true;
+        return true;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+size_t TimerWheel::size(void) {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+    return liveCount;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Timer &timer = timers[index];
+    timer.callback = nullptr;
+    timer.queued = false;
+    timer.generation++;
+    timer.next = freeList;
+    freeList = index;
+}
+
+// Level L holds timers due in [64^L, 64^(L+1)) ticks, hashed on the tick bits of that level
+void TimerWheel::link(uint32_t index) {
+    Timer &timer = timers[index];
+    if (timer.expiry <= currentTick) {
+        timer.expiry = currentTick + 1;
+    }
+
+    uint64_t place = timer.expiry;
+    uint64_t delta = place - currentTick;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1ULL << (TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    // Beyond the top level the timer waits in its furthest slot and is rehashed when that slot cascades
+    uint64_t horizon = (1ULL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    if (delta > horizon) {
+        place = currentTick + horizon;
+    }
+
+    unsigned slot = (place >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+    insert(index, level * TIMER_WHEEL_SLOTS + slot);
+}
+
+void TimerWheel::insert(uint32_t index, unsigned slot) {
+    Timer &timer = timers[index];
+    uint32_t &head = heads[slot];
+    timer.slot = slot;
+    timer.prev = none;
+    timer.next = head;
+    if (head != none) {
+        timers[head].prev = index;
+    }
+    head = index;
+    occupied[slot / TIMER_WHEEL_SLOTS] |= 1ULL << (slot % TIMER_WHEEL_SLOTS);
+    timer.queued = true;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Timer &timer = timers[index];
+    if (timer.prev != none) {
+        timers[timer.prev].next = timer.next;
+    }
+    else {
+        heads[timer.slot] = timer.next;
+    }
+    if (timer.next != none) {
+        timers[timer.next].prev = timer.prev;
+    }
+    if (heads[timer.slot] == none) {
+        occupied[timer.slot / TIMER_WHEEL_SLOTS] &= ~(1ULL << (timer.slot % TIMER_WHEEL_SLOTS));
+    }
+    timer.queued = false;
+}
+
+// Moves the slot that just came due at a higher level down to finer levels
+void TimerWheel::cascade(int level) {
+    unsigned slot = (currentTick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+    uint32_t index = heads[level * TIMER_WHEEL_SLOTS + slot];
+
+    heads[level * TIMER_WHEEL_SLOTS + slot] = none;
+    occupied[level] &= ~(1ULL << slot);
+    while (index != none) {
+        uint32_t next = timers[index].next;
+        // Due on this very tick: into the level 0 slot about to run, not pushed to the next tick
+        if (timers[index].expiry <= currentTick) {
+            insert(index, currentTick & (TIMER_WHEEL_SLOTS - 1));
+        }
+        else {
+            link(index);
+        }
+        index = next;
+    }
+}
+
+// Sleeps until the earliest non-empty level 0 slot or the next cascade that has work to move
+void TimerWheel::arm(void) {
+    uint64_t next = UINT64_MAX;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (occupied[level] == 0) {
+            continue;
+        }
+        uint64_t base = currentTick >> (TIMER_WHEEL_BITS * level);
+        uint64_t ahead = __builtin_ctzll(rotateRight(occupied[level], (base + 1) & (TIMER_WHEEL_SLOTS - 1))) + 1;
+        uint64_t due = (base + ahead) << (TIMER_WHEEL_BITS * level);
+        if (due < next) {
+            next = due;
+        }
+    }
+    if (next == armedTick) {
+        return;
+    }
+    armedTick = next;
+
+    struct itimerspec spec = {};
+    if (next != UINT64_MAX) {
+        uint64_t when = startNanos + next * TIMER_TICK_NS;
+        spec.it_value.tv_sec = when / 1000000000ULL;
+        spec.it_value.tv_nsec = when % 1000000000ULL;
+    }
+    if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, NULL) < 0) {
+        perror("Timer wheel arm failed");
+    }
+}
+
+void TimerWheel::run() {
+    struct pollfd fds[2];
+    std::vector<uint32_t> due;
+
+    fds[0].fd = timerFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = stopFd;
+    fds[1].events = POLLIN;
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Timer wheel poll failed");
+            return;
+        }
+        if (fds[1].revents & POLLIN) {
+            return;
+        }
+        uint64_t expirations;
+        if (read(timerFd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+            perror("Timer wheel read failed");
+        }
+
+        std::unique_lock<std::mutex> lock(wheelMutex);
+        uint64_t target = nowTick();
+        while (currentTick < target) {
+            if (liveCount == 0) {
+                currentTick = target;
+                break;
+            }
+            // Nothing at level 0 can fire before the next cascade boundary
+            if (occupied[0] == 0) {
+                uint64_t boundary = currentTick | (TIMER_WHEEL_SLOTS - 1);
+                if (boundary > currentTick) {
+                    currentTick = boundary < target ? boundary : target;
+                    continue;
+                }
+            }
+            currentTick++;
+            for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+                if (currentTick & ((1ULL << (TIMER_WHEEL_BITS * level)) - 1)) {
+                    break;
+                }
+                cascade(level);
+            }
+
+            unsigned slot = currentTick & (TIMER_WHEEL_SLOTS - 1);
+            due.clear();
+            for (uint32_t index = heads[slot]; index != none; index = timers[index].next) {
+                // Taken off the wheel now; a cancel before its turn only stops the callback
+                timers[index].queued = false;
+                timers[index].firing = true;
+                due.push_back(index);
+            }
+            heads[slot] = none;
+            occupied[0] &= ~(1ULL << slot);
+
+            for (uint32_t index : due) {
+                Timer &timer = timers[index];
+                if (!timer.cancelled) {
+                    lock.unlock();
+                    timer.callback();
+                    lock.lock();
+                }
+                timer.firing = false;
+
+                if (timer.cancelled) {
+                    release(index);
+                }
+                else if (timer.period == 0) {
+                    liveCount--;
+                    release(index);
+                }
+                else {
+                    // Periodic timers keep their phase unless the wheel fell a whole period behind
+                    timer.expiry += timer.period;
+                    link(index);
+                }
+                firedCv.notify_all();
+            }
+        }
+        armedTick = 0;
+        arm();
+    }
+}
+
+TimerWheel *timerWheel()
+{
+  // Function local so threads racing on first use still get one wheel
+  static TimerWheel wheel;
+  return &wheel;
+}
@@ -0,0 +1,88 @@
+/*
+    This file is a part of the wiringBone library
+    Hashed hierarchical timer wheel driven by one timerfd
+*/
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#define TIMER_TICK_NS 1000000ULL        // 1 ms resolution
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4            // 2^24 ticks (about 4.6 hours) before the top level recirculates
+
+typedef uint64_t TimerId;               // 0 is never a valid timer
+
+class TimerWheel {
+public:
+    typedef std::function<void()> Callback;
+
+    TimerWheel();
+    ~TimerWheel();
+
+    // Callbacks run one at a time on the wheel thread and should not block.
+    // Both return immediately and may be called from callbacks
+    TimerId schedule(uint32_t delay_ms, Callback callback);
+    TimerId schedulePeriodic(uint32_t period_ms, Callback callback, uint32_t firstDelay_ms = 0);
+    bool cancel(TimerId id);            // False if the timer already fired or was cancelled
+    // Like cancel(), then waits out a callback already running on the wheel thread.
+    // Called from a callback it only cancels, since it would be waiting on itself
+    bool cancelAndWait(TimerId id);
+
+    size_t size(void);                  // Live timers
+
+private:
+    static const uint32_t none = UINT32_MAX;
+
+    struct Timer {
+        uint64_t expiry;                // Absolute tick
+        uint32_t period;                // Ticks, 0 for one-shot
+        uint32_t generation;            // Bumped on release so stale ids miss
+        uint32_t prev, next;            // Slot list links
+        uint16_t slot;                  // level * TIMER_WHEEL_SLOTS + index while queued
+        bool queued;
+        bool firing;
+        bool cancelled;                 // Cancelled while its callback was running
+        Callback callback;
+    };
+
+    std::deque<Timer> timers;           // Stable storage, indexed by the low half of a TimerId
+    uint32_t freeList;
+    uint32_t heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    uint64_t occupied[TIMER_WHEEL_LEVELS];  // Bit per non-empty slot
+    uint64_t currentTick;               // Last tick processed
+    uint64_t startNanos;
+    uint64_t armedTick;
+    size_t liveCount;
+
+    std::mutex wheelMutex;
+    std::condition_variable firedCv;    // Signalled each time a due timer's callback is done
+    std::thread worker;
+    int timerFd;
+    int stopFd;
+
+    TimerId add(uint64_t delayNanos, uint32_t period, Callback callback);
+    Timer *lookup(TimerId id, uint32_t &index);
+    bool cancelLocked(TimerId id);
+    void insert(uint32_t index, unsigned slot);
+    void release(uint32_t index);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void cascade(int level);
+    void arm(void);
+    uint64_t nowTick(void);
+    void run();
+};
+
+// Shared wheel for the library and the parking system, started on first use
+TimerWheel *timerWheel();
+
+#endif
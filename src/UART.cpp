@@ -25,12 +25,18 @@
 #include <stdarg.h>
 #include <string.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <stropts.h>
 #include <asm/termios.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <errno.h>
+#include <chrono>
+#include <thread>
 
 #include "CommonDefines.h"
 #include "UART.h"
@@ -38,12 +44,33 @@
 
 extern int tcflush (int __fd, int __queue_selector) __THROW;
 
+#define SERIAL_RX_MASK (SERIAL_RX_BUFFER_SIZE - 1)
+
+// One I/O thread serves every open port; serialMutex orders port registration against event handling
+static int serialEpoll = -1;
+static std::mutex serialMutex;
+static std::once_flag serialThreadStarted;
+
+void HardwareSerial::init()
+{
+  fd = -1;
+  txLength = 0;
+  rxHead = 0;
+  rxTail = 0;
+  rxWaiting = false;
+  rxActive = false;
+  rxHighWater = 0;
+  rxOverruns = 0;
+}
+
 HardwareSerial::HardwareSerial(void)
 {
+  init();
 }
 
 HardwareSerial::HardwareSerial(int id)
 {
+  init();
   switch(id)
   {
     case 1: sprintf(this -> device , "/dev/ttyO1"); break;
@@ -56,6 +83,7 @@ HardwareSerial::HardwareSerial(int id)
 
 HardwareSerial::HardwareSerial(const char *dev)
 {
+  init();
   sprintf(this -> device , dev);
 }
 
@@ -85,6 +113,8 @@ void HardwareSerial::begin(unsigned long baud)
   terminal.c_cflag |= BOTHER;
   terminal.c_ispeed = baud;
   terminal.c_ospeed = baud;
+  terminal.c_cc[VMIN] = 1;
+  terminal.c_cc[VTIME] = 0;
 
   ioctl(fd, TCSETS2, &terminal);
 
@@ -94,54 +124,317 @@ void HardwareSerial::begin(unsigned long baud)
   status |= TIOCM_RTS ;
 
   ioctl (fd, TIOCMSET, &status);
+
+  std::call_once(serialThreadStarted, []
+  {
+    if((serialEpoll = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    perror("Serial epoll create failed");
+    else
+    std::thread(HardwareSerial::ioLoop).detach();
+  });
+
+  std::lock_guard<std::mutex> lock(serialMutex);
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.ptr = this;
+  rxHead = 0;
+  rxTail = 0;
+  if(epoll_ctl(serialEpoll, EPOLL_CTL_ADD, fd, &event) < 0)
+  perror("Serial epoll add failed");
+  else
+  rxActive = true;
 }
 
 void HardwareSerial::end()
 {
+  drain(NULL, 0);
+  {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    if(rxActive)
+    epoll_ctl(serialEpoll, EPOLL_CTL_DEL, fd, NULL);
+    rxActive = false;
+  }
+  wakeReaders();
   close(fd);
 }
 
 
 int HardwareSerial::available(void)
 {
-  int result ;
-
-  if (ioctl (fd, FIONREAD, &result) == -1)
-  return -1 ;
-
-  return result ;
+  return rxHead.load(std::memory_order_acquire) - rxTail.load(std::memory_order_relaxed);
 }
 
 int HardwareSerial::peek(void)
 {
-  int c;
-  FILE* fp = fdopen(fd, "r+");
-  c = getc(fp);
-  ungetc(c, fp);
-  return c;
+  size_t tail = rxTail.load(std::memory_order_relaxed);
+  if(rxHead.load(std::memory_order_acquire) == tail)
+  return -1;
+
+  return rxBuffer[tail & SERIAL_RX_MASK];
 }
 
 int HardwareSerial::read(void)
 {
-  uint8_t x ;
+  size_t tail = rxTail.load(std::memory_order_relaxed);
+  if(rxHead.load(std::memory_order_acquire) == tail)
+  return -1;
+
+  uint8_t x = rxBuffer[tail & SERIAL_RX_MASK];
+  rxTail.store(tail + 1, std::memory_order_release);
+  return x;
+}
+
+size_t HardwareSerial::readBytes(char *buffer, size_t length)
+{
+  size_t count = 0;
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_timeout);
+
+  while(count < length)
+  {
+    size_t tail = rxTail.load(std::memory_order_relaxed);
+    size_t ready = rxHead.load(std::memory_order_acquire) - tail;
+    if(ready > 0)
+    {
+      // Copy up to the end of the ring, the next pass picks up the wrapped part
+      size_t chunk = length - count;
+      if(chunk > ready)
+      chunk = ready;
+      if(chunk > SERIAL_RX_BUFFER_SIZE - (tail & SERIAL_RX_MASK))
+      chunk = SERIAL_RX_BUFFER_SIZE - (tail & SERIAL_RX_MASK);
+      memcpy(buffer + count, rxBuffer + (tail & SERIAL_RX_MASK), chunk);
+      rxTail.store(tail + chunk, std::memory_order_release);
+      count += chunk;
+      continue;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(now >= deadline || !waitReadable(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1))
+    break;
+  }
+  return count;
+}
+
+// The I/O thread owns the fd, so wait for it to fill the ring rather than polling the fd
+bool HardwareSerial::waitReadable(unsigned long timeout)
+{
+  if(available() > 0)
+  return true;
+
+  std::unique_lock<std::mutex> lock(rxMutex);
+  rxWaiting = true;
+  rxCv.wait_for(lock, std::chrono::milliseconds(timeout), [this] { return available() > 0 || !rxActive; });
+  // A pending onReadable() callback still needs the I/O thread to look
+  rxWaiting = (bool)rxReady;
+  return available() > 0;
+}
+
+// Up to the end of the ring; a wrapped remainder shows up once this part is consumed
+size_t HardwareSerial::peekWindow(const char *&window)
+{
+  size_t tail = rxTail.load(std::memory_order_relaxed);
+  size_t ready = rxHead.load(std::memory_order_acquire) - tail;
+  size_t contiguous = SERIAL_RX_BUFFER_SIZE - (tail & SERIAL_RX_MASK);
+  window = (const char*) rxBuffer + (tail & SERIAL_RX_MASK);
+  return ready < contiguous ? ready : contiguous;
+}
+
+void HardwareSerial::consume(size_t count)
+{
+  size_t tail = rxTail.load(std::memory_order_relaxed);
+  size_t ready = rxHead.load(std::memory_order_acquire) - tail;
+  rxTail.store(tail + (count < ready ? count : ready), std::memory_order_release);
+}
+
+size_t HardwareSerial::rxHighWaterMark(void)
+{
+  return rxHighWater.load(std::memory_order_relaxed);
+}
+
+unsigned long HardwareSerial::rxOverrunCount(void)
+{
+  return rxOverruns.load(std::memory_order_relaxed);
+}
+
+// Called on the I/O thread with serialMutex held, returns the bytes taken from the port
+ssize_t HardwareSerial::fill()
+{
+  uint8_t discard[256];
+  size_t head = rxHead.load(std::memory_order_relaxed);
+  size_t space = SERIAL_RX_BUFFER_SIZE - (head - rxTail.load(std::memory_order_acquire));
+  ssize_t count;
+
+  if(space == 0)
+  {
+    // Ring full: keep draining the port so the newest bytes are the ones lost
+    if((count = ::read(fd, discard, sizeof(discard))) > 0)
+    rxOverruns.store(rxOverruns.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    return count;
+  }
+
+  size_t chunk = SERIAL_RX_BUFFER_SIZE - (head & SERIAL_RX_MASK);
+  if(chunk > space)
+  chunk = space;
+  if((count = ::read(fd, rxBuffer + (head & SERIAL_RX_MASK), chunk)) <= 0)
+  return count;
+
+  rxHead.store(head + count, std::memory_order_release);
+  if(SERIAL_RX_BUFFER_SIZE - space + count > rxHighWater.load(std::memory_order_relaxed))
+  rxHighWater.store(SERIAL_RX_BUFFER_SIZE - space + count, std::memory_order_relaxed);
+
+  // Pairs with the waiter raising rxWaiting before it checks available()
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if(rxWaiting)
+  wakeReaders();
+  return count;
+}
+
+void HardwareSerial::wakeReaders()
+{
+  std::function<void()> callback;
+  {
+    std::lock_guard<std::mutex> lock(rxMutex);
+    rxCv.notify_all();
+    callback.swap(rxReady);
+  }
+  if(callback)
+  callback();
+}
+
+void HardwareSerial::onReadable(std::function<void()> callback)
+{
+  {
+    std::lock_guard<std::mutex> lock(rxMutex);
+    rxWaiting = true;
+    if(available() == 0 && rxActive)
+    {
+      rxReady = std::move(callback);
+      return;
+    }
+  }
+  callback();
+}
 
-  if (serialRead (fd, &x, 1) != 1)
-  return -1 ;
+void HardwareSerial::ioLoop()
+{
+  struct epoll_event events[8];
 
-  return ((int)x) & 0xFF ;
+  while(true)
+  {
+    int count = epoll_wait(serialEpoll, events, 8, -1);
+    if(count < 0)
+    {
+      if(errno != EINTR)
+      perror("Serial epoll wait failed");
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(serialMutex);
+    for(int index = 0; index < count; index++)
+    {
+      HardwareSerial *port = (HardwareSerial*) events[index].data.ptr;
+      if(!port -> rxActive)
+      continue;
+      if((events[index].events & EPOLLIN) && port -> fill() > 0)
+      continue;
+      if(events[index].events & (EPOLLHUP | EPOLLERR))
+      {
+        // Nothing left to read on a hung up port, stop it from waking the thread
+        epoll_ctl(serialEpoll, EPOLL_CTL_DEL, port -> fd, NULL);
+        port -> rxActive = false;
+        port -> wakeReaders();
+      }
+    }
+  }
 }
 
+// Sends anything buffered and waits until it has left the transmitter
 void HardwareSerial::flush()
 {
-  ioctl (fd, TCFLSH, TCIOFLUSH) ;
+  drain(NULL, 0);
+  ioctl (fd, TCSBRK, 1) ;
 }
 
 size_t HardwareSerial::write(uint8_t c)
 {
-  serialWrite (fd, &c, 1) ;
+  txBuffer[txLength++] = c;
+  if(c == '\n' || txLength == SERIAL_TX_BUFFER_SIZE)
+  drain(NULL, 0);
   return 1;
 }
 
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  // Too big to buffer, send what is buffered and the new data together
+  if(size > SERIAL_TX_BUFFER_SIZE - txLength)
+  {
+    struct iovec frame = {(void*)buffer, size};
+    return drain(&frame, 1) < 0 ? 0 : size;
+  }
+
+  memcpy(txBuffer + txLength, buffer, size);
+  txLength += size;
+  if(txLength == SERIAL_TX_BUFFER_SIZE || memchr(buffer, '\n', size) != NULL)
+  drain(NULL, 0);
+  return size;
+}
+
+size_t HardwareSerial::writeFrames(const struct iovec *frames, int count)
+{
+  size_t size = 0;
+  for(int index = 0; index < count; index++)
+  size += frames[index].iov_len;
+  return drain(frames, count) < 0 ? 0 : size;
+}
+
+// Writes the TX buffer followed by the given frames, resuming after partial writes.
+// Frames beyond what one writev takes go out in further IOV_MAX sized batches
+int HardwareSerial::drain(const struct iovec *frames, int count)
+{
+  struct iovec vector[IOV_MAX];
+  int total = 0, next = 0;
+
+  if(txLength > 0)
+  {
+    vector[total].iov_base = txBuffer;
+    vector[total].iov_len = txLength;
+    total++;
+  }
+
+  do
+  {
+    while(total < IOV_MAX && next < count)
+    vector[total++] = frames[next++];
+
+    int first = 0;
+    while(first < total)
+    {
+      ssize_t written = writev(fd, vector + first, total - first);
+      if(written < 0)
+      {
+        if(errno == EINTR)
+        continue;
+        perror("Serial write failed");
+        txLength = 0;
+        return -1;
+      }
+      while(first < total && (size_t)written >= vector[first].iov_len)
+      {
+        written -= vector[first].iov_len;
+        first++;
+      }
+      if(first < total)
+      {
+        vector[first].iov_base = (uint8_t*)vector[first].iov_base + written;
+        vector[first].iov_len -= written;
+      }
+    }
+    total = 0;
+  } while(next < count);
+
+  txLength = 0;
+  return 0;
+}
+
 size_t serialRead(int fd, void *buff, size_t nbytes)
 {
   return read(fd, buff, nbytes);
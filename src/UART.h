@@ -22,15 +22,45 @@
 #define UART_H
 
 #include <stdint.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include "PINS.h"
+#include "TASK.h"
 
 #include "Stream.h"
 
+#define SERIAL_TX_BUFFER_SIZE 256
+#define SERIAL_RX_BUFFER_SIZE 4096  // Power of two
+
 class HardwareSerial : public Stream
 {
   private:
     char device[128];
     int fd;
+    uint8_t txBuffer[SERIAL_TX_BUFFER_SIZE];
+    size_t txLength;
+
+    int drain(const struct iovec *frames, int count);
+
+    // Filled by the shared I/O thread, drained by the reader without locks
+    uint8_t rxBuffer[SERIAL_RX_BUFFER_SIZE];
+    std::atomic<size_t> rxHead;
+    std::atomic<size_t> rxTail;
+    std::atomic<bool> rxWaiting;
+    std::mutex rxMutex;
+    std::condition_variable rxCv;
+    std::atomic<bool> rxActive;
+    std::function<void()> rxReady;      // One-shot onReadable() callback, guarded by rxMutex
+    std::atomic<size_t> rxHighWater;    // Written by the I/O thread only, read from any thread
+    std::atomic<unsigned long> rxOverruns;
+
+    void init();
+    ssize_t fill();
+    void wakeReaders();
+    static void ioLoop();
 
   public:
     HardwareSerial(void);
@@ -43,12 +73,25 @@ class HardwareSerial : public Stream
     virtual int peek(void);
     virtual int read(void);
     virtual void flush(void);
+    virtual size_t readBytes(char *buffer, size_t length);
+    virtual bool waitReadable(unsigned long timeout);
+    virtual size_t peekWindow(const char *&window);
+    virtual void consume(size_t count);
     virtual size_t write(uint8_t);
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t writeFrames(const struct iovec *frames, int count); // Buffered bytes and frames in one writev
+
+    // Calls back once bytes are waiting or the port closes, from the I/O thread unless already readable
+    void onReadable(std::function<void()> callback);
+    ReadableAwaiter<HardwareSerial> readable(void) { return {*this}; }
     inline size_t write(unsigned long n) { return write((uint8_t)n); }
     inline size_t write(long n) { return write((uint8_t)n); }
     inline size_t write(unsigned int n) { return write((uint8_t)n); }
     inline size_t write(int n) { return write((uint8_t)n); }
     using Print::write;
+
+    size_t rxHighWaterMark(void);       // Most bytes ever waiting in the RX ring
+    unsigned long rxOverrunCount(void); // Bytes dropped because the RX ring was full
 };
 
 size_t serialRead(int fd, void *buff, size_t nbytes);
@@ -24,27 +24,29 @@ extern "C" {
   #include "twi.h"
 }
 
+#include <vector>
 #include "Wire.h"
+#include "I2CBus.h"
 
 // Initialize Class Variables //////////////////////////////////////////////////
 
-uint8_t TwoWire::rxBuffer[BUFFER_LENGTH];
-uint8_t TwoWire::rxBufferIndex = 0;
-uint8_t TwoWire::rxBufferLength = 0;
-
-uint8_t TwoWire::txAddress = 0;
-uint8_t TwoWire::txBuffer[BUFFER_LENGTH];
-uint8_t TwoWire::txBufferIndex = 0;
-uint8_t TwoWire::txBufferLength = 0;
-
-uint8_t TwoWire::transmitting = 0;
+TwoWire *TwoWire::slave = 0;
 void (*TwoWire::user_onRequest)(void);
 void (*TwoWire::user_onReceive)(int);
 
 // Constructors ////////////////////////////////////////////////////////////////
 
-TwoWire::TwoWire()
+TwoWire::TwoWire(int busNum)
 {
+  this -> busNum = busNum;
+  adapter = 0;
+  rxBufferIndex = 0;
+  rxBufferLength = 0;
+  txAddress = 0;
+  txBufferIndex = 0;
+  txBufferLength = 0;
+  transmitting = 0;
+  pendingRestart = 0;
 }
 
 // Public Methods //////////////////////////////////////////////////////////////
@@ -56,16 +58,17 @@ void TwoWire::begin(void)
 
   txBufferIndex = 0;
   txBufferLength = 0;
+  pendingRestart = 0;
 
-  twi_init();
+  adapter = i2cBus(busNum);
 }
 
 void TwoWire::begin(uint8_t address)
 {
-  twi_setAddress(address);
+  begin();
+  slave = this;
   twi_attachSlaveTxEvent(onRequestService);
   twi_attachSlaveRxEvent(onReceiveService);
-  begin();
 }
 
 void TwoWire::begin(int address)
@@ -73,38 +76,54 @@ void TwoWire::begin(int address)
   begin((uint8_t)address);
 }
 
-uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop)
+size_t TwoWire::requestFrom(uint8_t address, size_t quantity, uint8_t sendStop)
 {
-  // clamp to buffer length
-  if(quantity > BUFFER_LENGTH){
-    quantity = BUFFER_LENGTH;
+  ssize_t read;
+  // a held write to the same slave becomes the first half of a combined transfer
+  if(pendingRestart && txAddress == address){
+    read = quantity > BUFFER_LENGTH ? -1 : transfer(address, txBuffer, txBufferLength, rxBuffer, quantity);
+    pendingRestart = 0;
+    txBufferLength = 0;
+  }else{
+    flushPending();
+    // perform blocking read into buffer
+    read = quantity > BUFFER_LENGTH ? -1 : transfer(address, 0, 0, rxBuffer, quantity);
   }
-  // perform blocking read into buffer
-  uint8_t read = twi_readFrom(address, rxBuffer, quantity, sendStop);
   // set rx buffer iterator vars
   rxBufferIndex = 0;
-  rxBufferLength = read;
+  rxBufferLength = read < 0 ? 0 : read;
 
-  return read;
+  return rxBufferLength;
 }
 
-uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity)
+size_t TwoWire::requestFrom(uint8_t address, size_t quantity)
 {
-  return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)true);
+  return requestFrom(address, quantity, (uint8_t)true);
 }
 
-uint8_t TwoWire::requestFrom(int address, int quantity)
+size_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop)
 {
-  return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)true);
+  return requestFrom(address, (size_t)quantity, sendStop);
 }
 
-uint8_t TwoWire::requestFrom(int address, int quantity, int sendStop)
+size_t TwoWire::requestFrom(uint8_t address, uint8_t quantity)
 {
-  return requestFrom((uint8_t)address, (uint8_t)quantity, (uint8_t)sendStop);
+  return requestFrom(address, (size_t)quantity, (uint8_t)true);
+}
+
+size_t TwoWire::requestFrom(int address, int quantity)
+{
+  return requestFrom((uint8_t)address, (size_t)quantity, (uint8_t)true);
+}
+
+size_t TwoWire::requestFrom(int address, int quantity, int sendStop)
+{
+  return requestFrom((uint8_t)address, (size_t)quantity, (uint8_t)sendStop);
 }
 
 void TwoWire::beginTransmission(uint8_t address)
 {
+  flushPending();
   // indicate that we are transmitting
   transmitting = 1;
   // set address of targeted slave
@@ -121,13 +140,19 @@ void TwoWire::beginTransmission(int address)
 
 uint8_t TwoWire::endTransmission(uint8_t sendStop)
 {
+  // indicate that we are done transmitting
+  transmitting = 0;
+  // hold the buffer so the next requestFrom() can follow with a repeated start
+  if(!sendStop && txBufferLength > 0){
+    pendingRestart = 1;
+    txBufferIndex = 0;
+    return 0;
+  }
   // transmit buffer (blocking)
-  int8_t ret = twi_writeTo(txAddress, txBuffer, txBufferLength, 1, sendStop);
+  uint8_t ret = transfer(txAddress, txBuffer, txBufferLength, 0, 0) < 0 ? 1 : 0;
   // reset tx buffer iterator vars
   txBufferIndex = 0;
   txBufferLength = 0;
-  // indicate that we are done transmitting
-  transmitting = 0;
   return ret;
 }
 
@@ -136,6 +161,12 @@ uint8_t TwoWire::endTransmission(void)
   return endTransmission(true);
 }
 
+ssize_t TwoWire::writeRead(uint8_t address, const uint8_t *txData, size_t txLength, uint8_t *rxData, size_t rxLength)
+{
+  flushPending();
+  return transfer(address, txData, txLength, rxData, rxLength);
+}
+
 // must be called in:
 // slave tx event callback
 // or after beginTransmission(address)
@@ -226,23 +257,23 @@ void TwoWire::flush(void)
 void TwoWire::onReceiveService(uint8_t* inBytes, int numBytes)
 {
   // don't bother if user hasn't registered a callback
-  if(!user_onReceive){
+  if(!user_onReceive || !slave){
     return;
   }
   // don't bother if rx buffer is in use by a master requestFrom() op
   // i know this drops data, but it allows for slight stupidity
   // meaning, they may not have read all the master requestFrom() data yet
-  if(rxBufferIndex < rxBufferLength){
+  if(slave->rxBufferIndex < slave->rxBufferLength){
     return;
   }
   // copy twi rx buffer into local read buffer
   // this enables new reads to happen in parallel
-  for(uint8_t i = 0; i < numBytes; ++i){
-    rxBuffer[i] = inBytes[i];    
+  for(int i = 0; i < numBytes; ++i){
+    slave->rxBuffer[i] = inBytes[i];
   }
   // set rx iterator vars
-  rxBufferIndex = 0;
-  rxBufferLength = numBytes;
+  slave->rxBufferIndex = 0;
+  slave->rxBufferLength = numBytes;
   // alert user program
   user_onReceive(numBytes);
 }
@@ -251,17 +282,47 @@ void TwoWire::onReceiveService(uint8_t* inBytes, int numBytes)
 void TwoWire::onRequestService(void)
 {
   // don't bother if user hasn't registered a callback
-  if(!user_onRequest){
+  if(!user_onRequest || !slave){
     return;
   }
   // reset tx buffer iterator vars
   // !!! this will kill any pending pre-master sendTo() activity
-  txBufferIndex = 0;
-  txBufferLength = 0;
+  slave->txBufferIndex = 0;
+  slave->txBufferLength = 0;
   // alert user program
   user_onRequest();
 }
 
+// sends a write held by endTransmission(false) that was not followed by a read
+uint8_t TwoWire::flushPending(void)
+{
+  if(!pendingRestart){
+    return 0;
+  }
+  pendingRestart = 0;
+  uint8_t ret = transfer(txAddress, txBuffer, txBufferLength, 0, 0) < 0 ? 1 : 0;
+  txBufferIndex = 0;
+  txBufferLength = 0;
+  return ret;
+}
+
+// every transfer is queued on the adapter's scheduler, so Wire never
+// interleaves with a driver or thread using the same bus
+ssize_t TwoWire::transfer(uint8_t address, const uint8_t *txData, size_t txLength, uint8_t *rxData, size_t rxLength)
+{
+  if(!adapter){
+    adapter = i2cBus(busNum);
+  }
+  I2CResult result = adapter->transfer(address, std::vector<uint8_t>(txData, txData + txLength), rxLength);
+  if(result.status != 0){
+    return -1;
+  }
+  if(rxLength){
+    memcpy(rxData, result.data.data(), rxLength);
+  }
+  return rxLength;
+}
+
 // sets function called on slave write
 void TwoWire::onReceive( void (*function)(int) )
 {
@@ -276,5 +337,6 @@ void TwoWire::onRequest( void (*function)(void) )
 
 // Preinstantiate Objects //////////////////////////////////////////////////////
 
-TwoWire Wire = TwoWire();
+TwoWire Wire = TwoWire(1);
+TwoWire Wire2 = TwoWire(2);
 
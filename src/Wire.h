@@ -20,29 +20,40 @@
 #define TwoWire_h
 
 #include <inttypes.h>
+#include <stddef.h>
 #include "Stream.h"
+#include "twi.h"
 
-#define BUFFER_LENGTH 32
+#define BUFFER_LENGTH TWI_BUFFER_LENGTH
+
+class I2CBus;
 
 class TwoWire : public Stream
 {
   private:
-    static uint8_t rxBuffer[];
-    static uint8_t rxBufferIndex;
-    static uint8_t rxBufferLength;
+    I2CBus *adapter;  // Shared with every other user of the bus, set by begin()
+    int busNum;
+
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    size_t rxBufferIndex;
+    size_t rxBufferLength;
 
-    static uint8_t txAddress;
-    static uint8_t txBuffer[];
-    static uint8_t txBufferIndex;
-    static uint8_t txBufferLength;
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    size_t txBufferIndex;
+    size_t txBufferLength;
 
-    static uint8_t transmitting;
+    uint8_t transmitting;
+    uint8_t pendingRestart;  // txBuffer held by endTransmission(false) for a combined read
+    static TwoWire *slave;
     static void (*user_onRequest)(void);
     static void (*user_onReceive)(int);
     static void onRequestService(void);
     static void onReceiveService(uint8_t*, int);
+    uint8_t flushPending(void);
+    ssize_t transfer(uint8_t, const uint8_t *, size_t, uint8_t *, size_t);
   public:
-    TwoWire();
+    TwoWire(int busNum = 1);
     void begin();
     void begin(uint8_t);
     void begin(int);
@@ -50,10 +61,15 @@ class TwoWire : public Stream
     void beginTransmission(int);
     uint8_t endTransmission(void);
     uint8_t endTransmission(uint8_t);
-    uint8_t requestFrom(uint8_t, uint8_t);
-    uint8_t requestFrom(uint8_t, uint8_t, uint8_t);
-    uint8_t requestFrom(int, int);
-    uint8_t requestFrom(int, int, int);
+    size_t requestFrom(uint8_t, uint8_t);
+    size_t requestFrom(uint8_t, uint8_t, uint8_t);
+    size_t requestFrom(uint8_t, size_t);
+    size_t requestFrom(uint8_t, size_t, uint8_t);
+    size_t requestFrom(int, int);
+    size_t requestFrom(int, int, int);
+    // Register style access of any length: write then repeated start read in one transfer.
+    // Returns the bytes read, or -1 on error
+    ssize_t writeRead(uint8_t address, const uint8_t *txData, size_t txLength, uint8_t *rxData, size_t rxLength);
     virtual size_t write(uint8_t);
     virtual size_t write(const uint8_t *, size_t);
     virtual int available(void);
@@ -70,7 +86,8 @@ class TwoWire : public Stream
     using Print::write;
 };
 
-extern TwoWire Wire;
+extern TwoWire Wire;   // /dev/i2c-1
+extern TwoWire Wire2;  // /dev/i2c-2
 
 #endif
 
@@ -1,7 +1,7 @@
 #include "parking_system.h"
+#include "PWM.h"
 #include "utilities.h"
 #include <iostream>
-#include <thread>
 #include <fstream>
 #include <unistd.h>
 #include <fcntl.h>
@@ -10,8 +10,22 @@ ParkingSystem::ParkingSystem(int totalSpots)
     : totalSpots(totalSpots), 
       availableSpots(totalSpots), 
       stopFlag(false),
+      gateCenterDuty(GATE_CENTER_DUTY_CYCLE),
+      gateEntryDuty(GATE_ENTRY_DUTY_CYCLE),
+      gateExitDuty(GATE_EXIT_DUTY_CYCLE),
+      gateMotionTime(GATE_MOTION_TIME),
+      gatePassageDelay(GATE_PASSAGE_DELAY),
+      debounceDelay(SENSOR_DEBOUNCE_DELAY),
+      entryCount(0),
+      exitCount(0),
       currentOccupancy(totalSpots, false),
-      gateState(GateState::CENTERED) {
+      gateState(GateState::CENTERED),
+      gateBusy(false),
+      entryLastState(HIGH),
+      exitLastState(HIGH),
+      lastAvailable(-1),
+      lastGateState(GateState::CENTERED),
+      passageTimer(0) {
     // Initialize IR sensor pins using definitions from header
     irSensorPins.push_back(IR_SENSOR1_PIN);
     irSensorPins.push_back(IR_SENSOR2_PIN);
@@ -85,9 +99,44 @@ void ParkingSystem::updateSpotLEDs(int spotIndex, bool occupied) {
     }
 }
 
+// Missing keys fall back to the compiled-in defaults; only values set later are stored
+void ParkingSystem::loadConfiguration() {
+    ConfigStore *config = configStore();
+    if (!config->begin()) {
+        std::cerr << "Config store unavailable, using built-in defaults" << std::endl;
+        return;
+    }
+
+    int spots = config->value("spots", totalSpots);
+    if (spots < 1 || static_cast<size_t>(spots) > irSensorPins.size()) {
+        std::cerr << "Ignoring configured spot count " << spots << std::endl;
+    } else {
+        totalSpots = spots;
+        irSensorPins.resize(totalSpots);
+        greenLEDPins.resize(totalSpots);
+        redLEDPins.resize(totalSpots);
+        currentOccupancy.assign(totalSpots, false);
+    }
+
+    gateCenterDuty = config->value("gate.center", gateCenterDuty);
+    gateEntryDuty = config->value("gate.entry", gateEntryDuty);
+    gateExitDuty = config->value("gate.exit", gateExitDuty);
+    gateMotionTime = config->value("gate.motion", gateMotionTime);
+    gatePassageDelay = config->value("gate.passage", gatePassageDelay);
+    debounceDelay = config->value("sensor.debounce", debounceDelay);
+
+    // Cars parked before a restart are still there
+    int available = config->value("spots.available", totalSpots);
+    availableSpots = (available >= 0 && available <= totalSpots) ? available : totalSpots;
+    entryCount = config->value("count.entries", entryCount);
+    exitCount = config->value("count.exits", exitCount);
+}
+
 void ParkingSystem::initialize() {
     std::cout << "Initializing Parking System..." << std::endl;
 
+    loadConfiguration();
+
     if (!gpioInstance()) {
         std::cerr << "Critical Error: Failed to initialize GPIO instance!" << std::endl;
         exit(EXIT_FAILURE);
@@ -124,186 +173,202 @@ void ParkingSystem::initialize() {
         }
     }
 
-    // Initialize servo motor (PWM)
-    std::string pwmExportPath = "/sys/class/pwm/pwmchip4/export";
-    std::string pwmPeriodPath = "/sys/class/pwm/pwmchip4/pwm-4:0/period";
-    std::string pwmDutyCyclePath = "/sys/class/pwm/pwmchip4/pwm-4:0/duty_cycle";
-    std::string pwmEnablePath = "/sys/class/pwm/pwmchip4/pwm-4:0/enable";
-
-    if (access("/sys/class/pwm/pwmchip4/pwm-4:0", F_OK) != 0) {
-        writeToSysfs(pwmExportPath, "0");
+    // Initialize servo motor (PWM) on the channel discovered behind the gate pin
+    PWM* pwmController = pwmInstance();
+    gatePwmPath = pwmController->channelPath(gateControlPin.pinNum);
+    if (gatePwmPath.empty()) {
+        pwmController->exportPin(gateControlPin.pinNum);
+        usleep(100000); // Wait for export to complete
+        gatePwmPath = pwmController->channelPath(gateControlPin.pinNum);
+    }
+    if (gatePwmPath.empty()) {
+        std::cerr << "Failed to locate PWM channel for gate pin " << gateControlPin.pinName << std::endl;
+        exit(EXIT_FAILURE);
     }
 
-    writeToSysfs(pwmPeriodPath, std::to_string(PWM_PERIOD));
-    writeToSysfs(pwmDutyCyclePath, std::to_string(GATE_CENTER_DUTY_CYCLE));
-    writeToSysfs(pwmEnablePath, "1");
+    std::string pwmDutyCyclePath = gatePwmPath + "/duty_cycle";
+    writeToSysfs(gatePwmPath + "/period", std::to_string(PWM_PERIOD));
+    writeToSysfs(pwmDutyCyclePath, std::to_string(gateCenterDuty));
+    writeToSysfs(gatePwmPath + "/enable", "1");
+
+    gateMotion.reset(new ServoMotion([pwmDutyCyclePath](uint32_t ns) {
+        writeToSysfs(pwmDutyCyclePath, std::to_string(ns));
+    }, gateCenterDuty));
 
     std::cout << "Centering gate at startup..." << std::endl;
-    controlGate(GateState::CENTERED);
-    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    controlGate(GateState::CENTERED, true);
 
-    std::cout << "System initialized with " << totalSpots << " parking spots." << std::endl;
+    std::cout << "System initialized with " << totalSpots << " parking spots ("
+              << availableSpots << " available, " << entryCount << " entries and "
+              << exitCount << " exits so far)." << std::endl;
 }
 
-void ParkingSystem::controlGate(GateState newState) {
-    std::string pwmDutyCyclePath = "/sys/class/pwm/pwmchip4/pwm-4:0/duty_cycle";
-    
-    int dutyCycle;
+void ParkingSystem::controlGate(GateState newState, bool wait) {
+    uint32_t dutyCycle;
     switch(newState) {
         case GateState::OPEN_ENTRY:
             std::cout << "Opening gate for entry (clockwise)..." << std::endl;
-            dutyCycle = GATE_ENTRY_DUTY_CYCLE;
+            dutyCycle = gateEntryDuty;
             break;
         case GateState::OPEN_EXIT:
             std::cout << "Opening gate for exit (counter-clockwise)..." << std::endl;
-            dutyCycle = GATE_EXIT_DUTY_CYCLE;
+            dutyCycle = gateExitDuty;
             break;
         case GateState::CENTERED:
             std::cout << "Centering gate..." << std::endl;
-            dutyCycle = GATE_CENTER_DUTY_CYCLE;
+            dutyCycle = gateCenterDuty;
             break;
     }
 
-    writeToSysfs(pwmDutyCyclePath, std::to_string(dutyCycle));
-    gateState = newState;
+    // Ramp the servo instead of stepping it. Timer callbacks must not block the wheel,
+    // so unless asked to wait the state is updated once the gate has arrived
+    if (wait) {
+        gateMotion->moveTo(dutyCycle, gateMotionTime, scurve);
+        gateMotion->waitComplete();
+        gateState = newState;
+        return;
+    }
+    gateMotion->moveTo(dutyCycle, gateMotionTime, scurve, [this, newState] { gateState = newState; });
 }
 
 void ParkingSystem::run() {
-    std::thread spotThread(&ParkingSystem::monitorSpots, this);
-    std::thread exitThread(&ParkingSystem::monitorExitGateSensor, this);
-    std::thread entryThread(&ParkingSystem::monitorEntryGateSensor, this);
-    std::thread displayThread(&ParkingSystem::updateDisplay, this);
-
-    setThreadPriority(entryThread, 80); // High priority for entry sensor
-    setThreadPriority(exitThread, 80); // High priority for exit sensor
-    setThreadPriority(spotThread, 50); // Medium priority for spot monitoring
-    setThreadPriority(displayThread, 30); // Low priority for display updates
-
-    spotThread.detach();
-    exitThread.detach();
-    entryThread.detach();
-    displayThread.detach();
+    TimerWheel *wheel = timerWheel();
+    monitorTimers.push_back(wheel->schedulePeriodic(SPOT_POLL_INTERVAL, [this] { monitorSpots(); }));
+    monitorTimers.push_back(wheel->schedulePeriodic(GATE_POLL_INTERVAL, [this] { monitorExitGateSensor(); }));
+    monitorTimers.push_back(wheel->schedulePeriodic(GATE_POLL_INTERVAL, [this] { monitorEntryGateSensor(); }));
+    monitorTimers.push_back(wheel->schedulePeriodic(DISPLAY_REFRESH_INTERVAL, [this] { updateDisplay(); }));
 }
 
 void ParkingSystem::stop() {
-    {
-        std::lock_guard<std::mutex> lock(threadMutex);
-        stopFlag = true;
+    stopFlag = true;
+    // Monitors first: once none can run, passageTimer can no longer be rescheduled
+    for (TimerId timer : monitorTimers) {
+        timerWheel()->cancelAndWait(timer);
     }
-    cv.notify_all();
+    monitorTimers.clear();
+    timerWheel()->cancelAndWait(passageTimer);
+
+    std::lock_guard<std::mutex> lock(displayMutex);
 
     for (size_t i = 0; i < greenLEDPins.size(); ++i) {
         digitalWrite(greenLEDPins[i], LOW);
         digitalWrite(redLEDPins[i], LOW);
     }
 
-    controlGate(GateState::CENTERED);
-    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    writeToSysfs("/sys/class/pwm/pwmchip4/pwm-4:0/enable", "0");
+    controlGate(GateState::CENTERED, true);
+    writeToSysfs(gatePwmPath + "/enable", "0");
 }
 
 void ParkingSystem::monitorSpots() {
-    while (!stopFlag) {
-        for (size_t i = 0; i < irSensorPins.size(); ++i) {
-            int status = digitalRead(irSensorPins[i]);
-            if (status >= 0) {
-                std::lock_guard<std::mutex> lock(displayMutex);
-                bool occupied = (status == LOW);
-                if (occupied != currentOccupancy[i]) {
-                    currentOccupancy[i] = occupied;
-                    updateSpotLEDs(i, occupied);
-                }
+    if (stopFlag) return;
+
+    for (size_t i = 0; i < irSensorPins.size(); ++i) {
+        int status = digitalRead(irSensorPins[i]);
+        if (status >= 0) {
+            std::lock_guard<std::mutex> lock(displayMutex);
+            if (stopFlag) return;
+            bool occupied = (status == LOW);
+            if (occupied != currentOccupancy[i]) {
+                currentOccupancy[i] = occupied;
+                updateSpotLEDs(i, occupied);
             }
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 }
 
-void ParkingSystem::monitorEntryGateSensor() {
-    bool lastSensorState = HIGH;
-    std::chrono::steady_clock::time_point lastChange;
+void ParkingSystem::finishPassage(int spotChange) {
+    std::lock_guard<std::mutex> lock(displayMutex);
+    if (stopFlag) return;
 
-    while (!stopFlag) {
-        int sensorStatus = digitalRead(entryGateSensorPin);
-        if (sensorStatus < 0) continue;
+    ConfigStore *config = configStore();
+    if (spotChange < 0) {
+        availableSpots--;
+        config->put("count.entries", ++entryCount);
+    } else {
+        if (availableSpots < totalSpots) {
+            availableSpots++;
+        }
+        config->put("count.exits", ++exitCount);
+    }
+    config->put("spots.available", availableSpots.load());
+    controlGate(GateState::CENTERED);
+    gateBusy = false;
+}
 
-        auto now = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastChange);
+void ParkingSystem::monitorEntryGateSensor() {
+    if (stopFlag) return;
 
-        if (duration.count() >= SENSOR_DEBOUNCE_DELAY) {
-            std::lock_guard<std::mutex> lock(displayMutex);
+    int sensorStatus = digitalRead(entryGateSensorPin);
+    if (sensorStatus < 0) return;
 
-            if (sensorStatus == LOW && lastSensorState == HIGH) {
-                // Car detected at entry
-                if (availableSpots > 0) {
-                    controlGate(GateState::OPEN_ENTRY);
-                    // Decrement availability after car passes (with delay)
-                    std::this_thread::sleep_for(std::chrono::milliseconds(GATE_PASSAGE_DELAY));
-                    availableSpots--;
-                    controlGate(GateState::CENTERED);
-                }
-            }
+    auto now = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - entryLastChange);
 
-            lastSensorState = sensorStatus;
-            lastChange = now;
+    if (duration.count() >= debounceDelay) {
+        std::lock_guard<std::mutex> lock(displayMutex);
+        // stop() may have run while this waited for the lock
+        if (stopFlag) return;
+
+        if (sensorStatus == LOW && entryLastState == HIGH && !gateBusy) {
+            // Car detected at entry
+            if (availableSpots > 0) {
+                gateBusy = true;
+                controlGate(GateState::OPEN_ENTRY);
+                // Decrement availability after car passes (with delay once the gate is open)
+                passageTimer = timerWheel()->schedule(gateMotionTime + gatePassageDelay,
+                                                      [this] { finishPassage(-1); });
+            }
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        entryLastState = sensorStatus;
+        entryLastChange = now;
     }
 }
 
 void ParkingSystem::monitorExitGateSensor() {
-    bool lastSensorState = HIGH;
-    std::chrono::steady_clock::time_point lastChange;
+    if (stopFlag) return;
 
-    while (!stopFlag) {
-        int sensorStatus = digitalRead(exitGateSensorPin);
-        if (sensorStatus < 0) continue;
+    int sensorStatus = digitalRead(exitGateSensorPin);
+    if (sensorStatus < 0) return;
 
-        auto now = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastChange);
+    auto now = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - exitLastChange);
 
-        if (duration.count() >= SENSOR_DEBOUNCE_DELAY) {
-            std::lock_guard<std::mutex> lock(displayMutex);
-
-            if (sensorStatus == LOW && lastSensorState == HIGH) {
-                // Car detected at exit
-                controlGate(GateState::OPEN_EXIT);
-                // Increment availability after car passes (with delay)
-                std::this_thread::sleep_for(std::chrono::milliseconds(GATE_PASSAGE_DELAY));
-                if (availableSpots < totalSpots) {
-                    availableSpots++;
-                }
-                controlGate(GateState::CENTERED);
-            }
-
-            lastSensorState = sensorStatus;
-            lastChange = now;
+    if (duration.count() >= debounceDelay) {
+        std::lock_guard<std::mutex> lock(displayMutex);
+        // stop() may have run while this waited for the lock
+        if (stopFlag) return;
+
+        if (sensorStatus == LOW && exitLastState == HIGH && !gateBusy) {
+            // Car detected at exit
+            gateBusy = true;
+            controlGate(GateState::OPEN_EXIT);
+            // Increment availability after car passes (with delay once the gate is open)
+            passageTimer = timerWheel()->schedule(gateMotionTime + gatePassageDelay,
+                                                  [this] { finishPassage(1); });
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        exitLastState = sensorStatus;
+        exitLastChange = now;
     }
 }
 
 void ParkingSystem::updateDisplay() {
-    int lastAvailable = -1;
-    GateState lastGateState = GateState::CENTERED;
-
-    while (!stopFlag) {
-        std::lock_guard<std::mutex> lock(displayMutex);
-        
-        if (availableSpots != lastAvailable || gateState != lastGateState) {
-            std::cout << "Parking Status - Available: " << availableSpots 
-                      << "/" << totalSpots 
-                      << " (Occupied: " << (totalSpots - availableSpots) << ")"
-                      << " [Gate: " << (gateState == GateState::CENTERED ? "CENTERED" :
-                                      gateState == GateState::OPEN_ENTRY ? "ENTRY" : "EXIT")
-                      << "]" << std::endl;
-
-            lastAvailable = availableSpots;
-            lastGateState = gateState;
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    if (stopFlag) return;
+
+    std::lock_guard<std::mutex> lock(displayMutex);
+    if (stopFlag) return;
+    GateState currentGate = gateState;
+
+    if (availableSpots != lastAvailable || currentGate != lastGateState) {
+        std::cout << "Parking Status - Available: " << availableSpots 
+                  << "/" << totalSpots 
+                  << " (Occupied: " << (totalSpots - availableSpots) << ")"
+                  << " [Gate: " << (currentGate == GateState::CENTERED ? "CENTERED" :
+                                  currentGate == GateState::OPEN_ENTRY ? "ENTRY" : "EXIT")
+                  << "]" << std::endl;
+
+        lastAvailable = availableSpots;
+        lastGateState = currentGate;
     }
 }
@@ -4,24 +4,30 @@
 #include <vector>
 #include <atomic>
 #include <mutex>
-#include <condition_variable>
-#include <thread>
 #include <set>
 #include <string>
 #include <chrono>
+#include <memory>
 #include "GPIO.h"
 #include "OVERLAY.h"
 #include "PINS.h"
+#include "MOTION.h"
+#include "TIMER.h"
+#include "CONFIG.h"
 #include "utilities.h"
 
-// Define constants for gate control and timing
-#define GATE_CONTROL_PIN P9_14              // Servo motor pin for gate control
-#define GATE_CENTER_DUTY_CYCLE 1500000      // 1.5 ms - neutral position
-#define GATE_EXIT_DUTY_CYCLE 2000000        // 2.0 ms - counter clockwise (exit)
-#define GATE_ENTRY_DUTY_CYCLE 1000000       // 1.0 ms - clockwise (entry)
+// Defaults for gate control and timing, overridden by the config store keys noted
+#define GATE_CONTROL_PIN Pin{50, "P9_14", pwm, P9_14_modes, 2, none}  // Servo motor pin for gate control
+#define GATE_CENTER_DUTY_CYCLE 1500000      // 1.5 ms - neutral position (gate.center)
+#define GATE_EXIT_DUTY_CYCLE 2000000        // 2.0 ms - counter clockwise (gate.exit)
+#define GATE_ENTRY_DUTY_CYCLE 1000000       // 1.0 ms - clockwise (gate.entry)
 #define PWM_PERIOD 20000000                 // 20 ms period (50 Hz)
-#define GATE_PASSAGE_DELAY 5000             // 5 seconds delay for car passage
-#define SENSOR_DEBOUNCE_DELAY 500           // 500 ms debounce delay
+#define GATE_MOTION_TIME 600                // 600 ms S-curve travel between gate positions (gate.motion)
+#define GATE_PASSAGE_DELAY 5000             // 5 seconds delay for car passage (gate.passage)
+#define SENSOR_DEBOUNCE_DELAY 500           // 500 ms debounce delay (sensor.debounce)
+#define SPOT_POLL_INTERVAL 100              // ms between spot sensor scans
+#define GATE_POLL_INTERVAL 50               // ms between gate sensor reads
+#define DISPLAY_REFRESH_INTERVAL 200        // ms between status checks
 
 // Define IR sensor and gate sensor pins
 #define IR_SENSOR1_PIN Pin{44, "P8_12", gpio, P8_12_modes, 2, none}
@@ -63,31 +69,50 @@ private:
     Pin exitGateSensorPin;                   // IR sensor for detecting exiting cars
     Pin entryGateSensorPin;                  // IR sensor for detecting entering cars
     Pin gateControlPin;                      // Pin for controlling the gate
+    std::string gatePwmPath;                 // sysfs PWM channel directory driving the gate
 
     // LED pins
     std::vector<Pin> greenLEDPins;           // Green LEDs for available spots
     std::vector<Pin> redLEDPins;             // Red LEDs for occupied spots
 
+    // Configuration, read from the config store at initialize()
+    uint32_t gateCenterDuty, gateEntryDuty, gateExitDuty;
+    uint32_t gateMotionTime, gatePassageDelay;
+    uint32_t debounceDelay;
+
+    // Counters persisted across restarts
+    uint32_t entryCount, exitCount;
+
     // Synchronization primitives
-    std::mutex threadMutex;
     std::mutex displayMutex;
-    std::condition_variable cv;
 
     // State tracking
     std::vector<bool> currentOccupancy;      // Occupancy status of each parking spot
-    GateState gateState;                     // Current gate position
+    std::atomic<GateState> gateState;        // Current gate position, set once the gate arrives
+    std::unique_ptr<ServoMotion> gateMotion; // Streams gate travel profiles to the servo
+    bool gateBusy;                           // A car is passing, other triggers are ignored
+    bool entryLastState, exitLastState;      // Gate sensor levels at the last debounced read
+    std::chrono::steady_clock::time_point entryLastChange, exitLastChange;
+    int lastAvailable;                       // Last status printed
+    GateState lastGateState;
+
+    // Scheduled work on the shared timer wheel
+    std::vector<TimerId> monitorTimers;
+    TimerId passageTimer;
 
     // Helper methods
-    void controlGate(GateState newState);
+    void loadConfiguration();
+    void controlGate(GateState newState, bool wait = false);
     void updateSpotLEDs(int spotIndex, bool occupied);
     bool initializeLEDPin(Pin& pin, const char* type, int index);
+    void finishPassage(int spotChange);      // Adjusts availability and closes the gate
 
-    // Monitoring threads
+    // Periodic timer callbacks
     void monitorSpots();                     // Monitor parking spot sensors
     void monitorEntryGateSensor();           // Monitor entry gate
     void monitorExitGateSensor();            // Monitor exit gate
     void updateDisplay();                    // Update display with status
-    
+
 };
 
 #endif // PARKING_SYSTEM_H
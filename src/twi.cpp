@@ -0,0 +1,149 @@
+/*
+    This file is a part of the wiringBone library
+    Copyright (C) 2015 Abhraneel Bera
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 3 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+    USA
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <errno.h>
+#include "i2c-dev.h"
+#include "twi.h"
+
+static void (*twi_onSlaveTransmit)(void);
+static void (*twi_onSlaveReceive)(uint8_t*, int);
+
+int twi_init(twi_bus *bus, int busNum)
+{
+  char device[16];
+  sprintf(device, "/dev/i2c-%d", busNum);
+  bus -> address = -1;
+  if((bus -> fd = open(device, O_RDWR)) < 0)
+  perror("i2c open failed");
+  return bus -> fd;
+}
+
+int twi_setAddress(twi_bus *bus, int deviceAddress)
+{
+  // The adapter keeps the slave address, only re-address on change
+  if(bus -> address == deviceAddress)
+  return bus -> fd;
+
+  if((ioctl(bus -> fd, I2C_SLAVE, deviceAddress)) < 0)
+  {
+    bus -> address = -1;
+    return -1;
+  }
+
+  bus -> address = deviceAddress;
+  return bus -> fd;
+}
+
+uint8_t twi_writeTo(twi_bus *bus, uint8_t address, uint8_t* data, size_t length, uint8_t wait, uint8_t sendStop)
+{
+  if(TWI_BUFFER_LENGTH < length)
+  return 1;
+  if(length == 0)
+  return 0;
+
+  int fd = twi_setAddress(bus, address);
+  if(fd < 0 || write(fd, data, length) != (ssize_t)length)
+  {
+    perror("Failed to write bytes");
+    return 1;
+  }
+  return 0;
+}
+
+size_t twi_readFrom(twi_bus *bus, uint8_t address, uint8_t* data, size_t length, uint8_t sendStop)
+{
+  if(TWI_BUFFER_LENGTH < length)
+  return 0;
+
+  int fd = twi_setAddress(bus, address);
+  if(fd < 0 || read(fd, data, length) != (ssize_t)length)
+  {
+    perror("Failed to read bytes");
+    return 0;
+  }
+  return length;
+}
+
+// Write followed by a repeated start read, both in a single I2C_RDWR transfer.
+// Returns the bytes read, so 0 for a write only transfer, or -1 on error
+ssize_t twi_writeRead(twi_bus *bus, uint8_t address, const uint8_t* txData, size_t txLength, uint8_t* rxData, size_t rxLength)
+{
+  struct i2c_msg msgs[2];
+  struct i2c_rdwr_ioctl_data transfer;
+
+  if(TWI_BUFFER_LENGTH < txLength || TWI_BUFFER_LENGTH < rxLength)
+  return -1;
+
+  transfer.msgs = msgs;
+  transfer.nmsgs = 0;
+  if(txLength > 0)
+  {
+    msgs[transfer.nmsgs].addr = address;
+    msgs[transfer.nmsgs].flags = 0;
+    msgs[transfer.nmsgs].len = txLength;
+    msgs[transfer.nmsgs].buf = (char*) txData;
+    transfer.nmsgs++;
+  }
+  if(rxLength > 0)
+  {
+    msgs[transfer.nmsgs].addr = address;
+    msgs[transfer.nmsgs].flags = I2C_M_RD;
+    msgs[transfer.nmsgs].len = rxLength;
+    msgs[transfer.nmsgs].buf = (char*) rxData;
+    transfer.nmsgs++;
+  }
+  if(transfer.nmsgs == 0)
+  return 0;
+
+  if(ioctl(bus -> fd, I2C_RDWR, &transfer) < 0)
+  {
+    perror("Failed to transfer bytes");
+    return -1;
+  }
+  return rxLength;
+}
+
+uint8_t twi_transmit(const uint8_t* data, uint8_t length)
+{
+  // Function for slave mode. Not required.
+  // Dummy
+  return 0;
+}
+
+void twi_attachSlaveRxEvent( void (*function)(uint8_t*, int) )
+{
+  twi_onSlaveReceive = function;
+}
+
+void twi_attachSlaveTxEvent( void (*function)(void) )
+{
+  twi_onSlaveTransmit = function;
+}
+
+void setWriteError()
+{
+  // Dummy
+}
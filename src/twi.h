@@ -21,111 +21,35 @@
 #ifndef TWI_H
 #define TWI_H
 
-#include <stdio.h>
-#include <string.h>
-#include <fcntl.h>
+#include <stddef.h>
 #include <stdint.h>
-#include <sys/ioctl.h>
-#include <unistd.h>
-#include <errno.h>
-#include "i2c-dev.h"
+#include <sys/types.h>
 
-#define TWI_BUFFER_LENGTH 32
+#define TWI_BUFFER_LENGTH 8192 // Largest message the kernel accepts through I2C_RDWR
 
-static void (*twi_onSlaveTransmit)(void);
-static void (*twi_onSlaveReceive)(uint8_t*, int);
+#ifdef __cplusplus
+extern "C" {
+#endif
 
-int fd_i2c, regAddress;
-
-void twi_init()
-{
-  if((fd_i2c = open("/dev/i2c-1", O_RDWR)) < 0)
-  perror("i2c open failed");
-}
-
-int twi_setAddress(int deviceAddress)
-{
-  if((ioctl(fd_i2c, I2C_SLAVE, deviceAddress)) < 0)
-  return -1;
-
-  return fd_i2c;
-}
-
-uint8_t twi_writeTo(uint8_t address, uint8_t* data, uint8_t length, uint8_t wait, uint8_t sendStop)
-{
-  int fd = twi_setAddress(address);
-  if(TWI_BUFFER_LENGTH < length)
-  return 1;
-  //if(sendStop == 1)  // To be implemented
-  //{
-    if(length == 0)
-    {
-      regAddress = 0;
-      return 0;
-    }
-    else if(length == 1)
-    {
-      regAddress = data[0];
-      if(i2c_smbus_write_byte(fd, data[0]) < 0)
-      {
-        perror("Failed to write byte");
-        return 1;
-      }
-    }
-    else
-    {
-      regAddress = 0;
-      if(i2c_smbus_write_i2c_block_data(fd, data[0], length-1, data+1) < 0)
-      {
-        perror("Failed to write bytes");
-        return 1;
-      }
-    }
-  //}
-  //else
-  //{ // To be implemented 
-  //}
-  return 0;
-}
-
-uint8_t twi_readFrom(uint8_t address, uint8_t* data, uint8_t length, uint8_t sendStop)
+// One /dev/i2c-N adapter
+typedef struct
 {
-  int fd = twi_setAddress(address);
-  if(TWI_BUFFER_LENGTH < length)
-  return 0;
-  //if(sendStop == 1)  // To be implemented
-  //{
-      if(i2c_smbus_read_i2c_block_data(fd, regAddress, length, data) < 0)
-      {
-        perror("Failed to read bytes");
-        return 0;
-      }
-  //}
-  //else
-  //{ // To be implemented 
-  //}
-  return length;
-}
-
-uint8_t twi_transmit(const uint8_t* data, uint8_t length)
-{
-  // Function for slave mode. Not required.
-  // Dummy
-  return 0;
-}
+  int fd;
+  int address;  // Slave address last set with I2C_SLAVE, -1 if none
+} twi_bus;
 
-void twi_attachSlaveRxEvent( void (*function)(uint8_t*, int) )
-{
-  twi_onSlaveReceive = function;
-}
+int twi_init(twi_bus *bus, int busNum);
+int twi_setAddress(twi_bus *bus, int deviceAddress);
+uint8_t twi_writeTo(twi_bus *bus, uint8_t address, uint8_t* data, size_t length, uint8_t wait, uint8_t sendStop);
+size_t twi_readFrom(twi_bus *bus, uint8_t address, uint8_t* data, size_t length, uint8_t sendStop);
+ssize_t twi_writeRead(twi_bus *bus, uint8_t address, const uint8_t* txData, size_t txLength, uint8_t* rxData, size_t rxLength);
+uint8_t twi_transmit(const uint8_t* data, uint8_t length);
+void twi_attachSlaveRxEvent( void (*function)(uint8_t*, int) );
+void twi_attachSlaveTxEvent( void (*function)(void) );
+void setWriteError();
 
-void twi_attachSlaveTxEvent( void (*function)(void) )
-{
-  twi_onSlaveTransmit = function;
+#ifdef __cplusplus
 }
+#endif
 
-void setWriteError()
-{
-  // Dummy
-}
-#endif
\ No newline at end of file
+#endif